@@ -0,0 +1,107 @@
+/*
+ * WTEngine Benchmark
+ * By:  Matthew Evans
+ * File:  main.cpp
+ *
+ * See LICENSE.md for copyright information
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+
+#include <wtengine/wtengine.hpp>
+
+//  Stops the compiler from removing the benchmark loops.
+static volatile float sink = 0.0f;
+
+//  Time a function, returning the nanoseconds taken.
+template <typename F>
+static double time_ns(F func) {
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+/*
+ * Move entities with the movement system, half of them with physics.
+ * Entities never sleep and bounce between the edges of their bounding box.
+ */
+static void bench_movement(const std::size_t& count, const std::size_t& ticks) {
+    for(std::size_t i = 0; i < count; i++) {
+        const wte::entity_id e_id = wte::mgr::world::new_entity();
+        const float dir = static_cast<float>(i % 628) / 100.0f;
+        wte::mgr::world::add_component<wte::cmp::location>(e_id, static_cast<float>(i % 1000), static_cast<float>(i % 700));
+        wte::mgr::world::add_component<wte::cmp::motion>(e_id, dir, 3.0f, 3.0f);
+        wte::mgr::world::add_component<wte::cmp::bounding_box>(e_id, 0.0f, 0.0f, 1000.0f, 700.0f);
+        if(i % 2 == 0) {
+            wte::mgr::world::add_component<wte::cmp::physics>(e_id, 1.0f, 0.01f, 8.0f);
+            wte::mgr::world::set_component<wte::cmp::physics>(e_id)->accel_y = 0.1f;
+        }
+    }
+
+    wte::sys::movement moving(0, 1);
+    moving.run();  //  Build the cache before timing.
+    const double ns = time_ns([&]() {
+        for(std::size_t t = 0; t < ticks; t++) moving.run();
+    });
+    std::printf("movement:  %zu entities, %zu ticks, %.2f ns per entity per tick\n",
+        count, ticks, ns / static_cast<double>(count * ticks));
+}
+
+/*
+ * Time each sim_math function and a multiply add over a set of values.
+ */
+static void bench_math(const std::size_t& count) {
+    std::vector<wte::sim_float> values(1024);
+    for(std::size_t i = 0; i < values.size(); i++)
+        values[i] = wte::sim_float(static_cast<float>(i) / 100.0f + 0.01f);
+    const std::size_t runs = count / values.size() + 1;
+    const double ops = static_cast<double>(runs * values.size());
+
+    wte::sim_float acc = 0;
+    double ns = time_ns([&]() {
+        for(std::size_t r = 0; r < runs; r++)
+            for(auto& it: values) acc = acc * wte::sim_float(0.5f) + it;
+    });
+    std::printf("mul add:   %.2f ns per op\n", ns / ops);
+    sink = sink + static_cast<float>(acc);
+
+    acc = 0;
+    ns = time_ns([&]() {
+        for(std::size_t r = 0; r < runs; r++)
+            for(auto& it: values) acc += wte::sim_math::sqrt(it);
+    });
+    std::printf("sqrt:      %.2f ns per op\n", ns / ops);
+    sink = sink + static_cast<float>(acc);
+
+    acc = 0;
+    ns = time_ns([&]() {
+        for(std::size_t r = 0; r < runs; r++)
+            for(auto& it: values) acc += wte::sim_math::sin(it) + wte::sim_math::cos(it);
+    });
+    std::printf("sin + cos: %.2f ns per op\n", ns / ops);
+    sink = sink + static_cast<float>(acc);
+
+    acc = 0;
+    ns = time_ns([&]() {
+        for(std::size_t r = 0; r < runs; r++)
+            for(auto& it: values) acc += wte::sim_math::atan2(it, wte::sim_float(1.5f));
+    });
+    std::printf("atan2:     %.2f ns per op\n", ns / ops);
+    sink = sink + static_cast<float>(acc);
+}
+
+/*
+ * Usage:  wte_bench [entities] [ticks]
+ */
+int main(int argc, char **argv) {
+    const std::size_t entities = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000);
+    const std::size_t ticks = (argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000);
+
+    std::printf("sim_float: %s\n", (wte::build_options.fixed_point ? "fixed" : "float"));
+    bench_movement(entities, ticks);
+    bench_math(entities * ticks);
+    return 0;
+}
@@ -27,6 +27,10 @@ namespace player_pols {
     static void reset(void) { x = y = 0.0f; };
 }
 
+namespace cannon_targets {
+    static std::set<std::string> names;
+}
+
 int main(int argc, char **argv) {
     //  Set locations to load game data from.
     wte::engine::add_file_location("data.zip");
@@ -318,6 +322,9 @@ int main(int argc, char **argv) {
                     wte::mgr::world::set_component<wte::cmp::gfx::overlay>(ovr_id)->draw_text(std::to_string(wte::mgr::variables::get<int>("hiscore")), al_map_rgb(255,255,255), 110, 10, ALLEGRO_ALIGN_LEFT);
                 }
             );  //  End score overlay drawing.
+            //  Only redraw when the score changes.
+            wte::mgr::world::set_component<wte::cmp::gfx::overlay>(e_id)->watch("score");
+            wte::mgr::world::set_component<wte::cmp::gfx::overlay>(e_id)->watch("hiscore");
         }
     );
 
@@ -341,6 +348,11 @@ int main(int argc, char **argv) {
                     wte::mgr::world::set_component<wte::cmp::gfx::overlay>(ovr_id)->draw_text("Lives:  " + std::to_string(wte::mgr::variables::get<int>("lives")), al_map_rgb(255,255,255), 200, 10, ALLEGRO_ALIGN_RIGHT);
                 }
             );  //  End info overlay drawing.
+            //  Only redraw when the lives or shield energy change.
+            wte::mgr::world::set_component<wte::cmp::gfx::overlay>(e_id)->watch("lives");
+            wte::mgr::world::set_component<wte::cmp::gfx::overlay>(e_id)->watch_value([]() {
+                return wte::mgr::world::get_component<energy>(wte::mgr::world::get_id("shield"))->amt;
+            });
         }
     );
 
@@ -482,6 +494,17 @@ int main(int argc, char **argv) {
                     wte::mgr::world::set_component<wte::cmp::location>(can_id)->pos_y =
                         wte::mgr::world::get_component<wte::cmp::location>(player_entity)->pos_y -
                         wte::mgr::world::get_component<wte::cmp::hitbox>(can_id)->height;
+
+                    //  Deal damage to everything the cannon is touching.
+                    for(auto it = cannon_targets::names.begin(); it != cannon_targets::names.end();) {
+                        if(wte::mgr::world::get_id(*it) == wte::mgr::world::ENTITY_ERROR) {
+                            it = cannon_targets::names.erase(it);
+                            continue;
+                        }
+                        wte::mgr::messages::add(wte::message("entities", *it, wte::mgr::world::get_name(can_id),
+                            "damage", std::to_string(wte::mgr::world::get_component<damage>(can_id)->dmg)));
+                        it++;
+                    }
                 }
             );  //  End cannon logic.
             wte::mgr::world::set_component<wte::cmp::ai>(e_id)->enabled = false;
@@ -489,11 +512,9 @@ int main(int argc, char **argv) {
             //  Cannon message processing.
             wte::mgr::world::add_component<wte::cmp::dispatcher>(e_id,
                 [](const wte::entity_id& can_id, const wte::message& msg) {
-                    if(msg.get_cmd() == "colision") {
-                        //  Deal damage
-                        wte::mgr::messages::add(wte::message("entities", msg.get_from(), msg.get_to(),
-                            "damage", std::to_string(wte::mgr::world::get_component<damage>(can_id)->dmg)));
-                    }
+                    //  Track what the cannon is touching.  Damage is dealt by the cannon logic.
+                    if(msg.get_cmd() == "colision") cannon_targets::names.insert(msg.get_from());
+                    if(msg.get_cmd() == "colision_end") cannon_targets::names.erase(msg.get_from());
                 }
             );  //  End cannon message processing.
         }
@@ -580,6 +601,8 @@ int main(int argc, char **argv) {
             wte::mgr::world::set_name(e_id, "asteroid" + std::to_string(e_id));
             wte::mgr::world::add_component<wte::cmp::location>(e_id, std::stof(args[1]), std::stof(args[2]));
             wte::mgr::world::add_component<wte::cmp::hitbox>(e_id, (float)(temp_size * 16), (float)(temp_size * 16), 1);
+            //  Use swept colision if the asteroid can move past its hitbox in one tick.
+            wte::mgr::world::set_component<wte::cmp::hitbox>(e_id)->fast = (std::stof(args[4]) >= (float)(temp_size * 16));
             wte::mgr::world::add_component<health>(e_id, temp_size * 10, temp_size * 10);
             wte::mgr::world::add_component<damage>(e_id, 10);
             wte::mgr::world::add_component<size>(e_id, temp_size);
@@ -666,6 +689,8 @@ int main(int argc, char **argv) {
     };
 
     wte::engine::new_game = [](){
+        cannon_targets::names.clear();
+
         //  Spawn starting entities
         wte::mgr::spawner::spawn("starfield", {});
         wte::mgr::spawner::spawn("score_overlay", {});
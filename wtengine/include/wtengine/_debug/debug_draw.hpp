@@ -0,0 +1,154 @@
+/*
+ * wtengine
+ * --------
+ * By Matthew Evans
+ * See LICENSE.md for copyright information.
+ */
+
+#if !defined(WTE_DEBUG_DRAW_HPP)
+#define WTE_DEBUG_DRAW_HPP
+
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_font.h>
+#include <allegro5/allegro_primitives.h>
+
+namespace wte::mgr::gfx {
+  class renderer;
+}
+
+namespace wte {
+
+/*!
+ * \class debug_draw
+ * \brief Queue shapes and text to draw over the world for debugging.
+ *
+ * Positions are in viewport pixels.  Everything queued is drawn by the renderer on the
+ * next frame, then cleared.  Rectangles and lines are put in one vertex batch and drawn
+ * with a single primitives call.
+ */
+class debug_draw final {
+  friend class mgr::gfx::renderer;
+
+  public:
+    debug_draw() = delete;
+    ~debug_draw() = delete;
+
+    /*!
+     * \brief Queue a rectangle.
+     * \param x Left of the rectangle.
+     * \param y Top of the rectangle.
+     * \param w Width of the rectangle.
+     * \param h Height of the rectangle.
+     * \param c Color.
+     * \param filled True to fill, false to outline.
+     */
+    static void rect(
+      const float& x, const float& y,
+      const float& w, const float& h,
+      const ALLEGRO_COLOR& c,
+      const bool& filled
+    ) {
+      if(filled) {
+        quad(x, y, x + w, y, x + w, y + h, x, y + h, c);
+      } else {
+        line(x, y, x + w, y, c);
+        line(x + w, y, x + w, y + h, c);
+        line(x + w, y + h, x, y + h, c);
+        line(x, y + h, x, y, c);
+      }
+    };
+
+    /*!
+     * \brief Queue a one pixel line.
+     * \param x1 Start X.
+     * \param y1 Start Y.
+     * \param x2 End X.
+     * \param y2 End Y.
+     * \param c Color.
+     */
+    static void line(
+      const float& x1, const float& y1,
+      const float& x2, const float& y2,
+      const ALLEGRO_COLOR& c
+    ) {
+      const float len = std::sqrt((x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1));
+      if(len == 0.0f) return;
+      //  Half a pixel out to each side.
+      const float nx = -(y2 - y1) / len * 0.5f, ny = (x2 - x1) / len * 0.5f;
+      quad(x1 + nx, y1 + ny, x2 + nx, y2 + ny, x2 - nx, y2 - ny, x1 - nx, y1 - ny, c);
+    };
+
+    /*!
+     * \brief Queue text.  Drawn with the renderer's font.
+     * \param x Left of the text.
+     * \param y Top of the text.
+     * \param c Color.
+     * \param s Text to draw.
+     */
+    static void text(
+      const float& x, const float& y,
+      const ALLEGRO_COLOR& c,
+      const std::string& s
+    ) {
+      texts.push_back({ x, y, c, s });
+    };
+
+  private:
+    struct text_item {
+      float x, y;
+      ALLEGRO_COLOR color;
+      std::string str;
+    };
+
+    //  Add two triangles for a quad with corners in order.
+    static void quad(
+      const float& x1, const float& y1, const float& x2, const float& y2,
+      const float& x3, const float& y3, const float& x4, const float& y4,
+      const ALLEGRO_COLOR& c
+    ) {
+      const ALLEGRO_VERTEX a = { x1, y1, 0.0f, 0.0f, 0.0f, c };
+      const ALLEGRO_VERTEX b = { x2, y2, 0.0f, 0.0f, 0.0f, c };
+      const ALLEGRO_VERTEX d = { x3, y3, 0.0f, 0.0f, 0.0f, c };
+      const ALLEGRO_VERTEX e = { x4, y4, 0.0f, 0.0f, 0.0f, c };
+      vertices.insert(vertices.end(), { a, b, d, a, d, e });
+    };
+
+    //  Move everything queued into a frame, leaving the queue empty.
+    static void take(std::vector<ALLEGRO_VERTEX>& v, std::vector<text_item>& t) {
+      v.swap(vertices);
+      t.swap(texts);
+      clear();
+    };
+
+    //  Draw the shapes and text of a frame to the current target.
+    static void draw(
+      const std::vector<ALLEGRO_VERTEX>& v,
+      const std::vector<text_item>& t,
+      ALLEGRO_FONT* font
+    ) {
+      if(!v.empty())
+        al_draw_prim(v.data(), NULL, NULL, 0, (int)v.size(), ALLEGRO_PRIM_TRIANGLE_LIST);
+      if(font && !t.empty()) {
+        al_hold_bitmap_drawing(true);
+        for(auto& it: t) al_draw_text(font, it.color, it.x, it.y, ALLEGRO_ALIGN_LEFT, it.str.c_str());
+        al_hold_bitmap_drawing(false);
+      }
+    };
+
+    //  Clear everything queued.
+    static void clear(void) {
+      vertices.clear();
+      texts.clear();
+    };
+
+    inline static std::vector<ALLEGRO_VERTEX> vertices;  //  Rectangles and lines.
+    inline static std::vector<text_item> texts;          //  Text.
+};
+
+}  //  end namespace wte
+
+#endif
@@ -0,0 +1,170 @@
+/*
+ * wtengine
+ * --------
+ * By Matthew Evans
+ * See LICENSE.md for copyright information.
+ */
+
+#if !defined(WTE_FRAME_TIMING_HPP)
+#define WTE_FRAME_TIMING_HPP
+
+#include <string>
+#include <array>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+
+#include "wtengine/_globals/_defines.hpp"
+
+namespace wte {
+
+/*!
+ * \class frame_timing
+ * \brief Rolling histogram of frame times.
+ *
+ * Keeps the times of the last WINDOW frames, and a histogram of them in buckets of
+ * BUCKET_MS, so percentiles are found without sorting.  Times past the last bucket
+ * are counted in it.  Frames taking longer than the budget are counted as over budget.
+ */
+class frame_timing final {
+  public:
+    /*!
+     * \brief Create frame timing with a budget of one tick.
+     */
+    frame_timing() : budget(1000.0f / build_options.ticks_per_sec), next(0), used(0), over(0), total(0.0) {
+      times.fill(0.0f);
+      buckets.fill(0);
+    };
+
+    ~frame_timing() = default;
+
+    /*!
+     * \brief Add the time of a frame, dropping the oldest once the window is full.
+     * \param ms Frame time in milliseconds.
+     */
+    void add(const float& ms) {
+      if(used == WINDOW) {
+        buckets[bucket(times[next])]--;
+        if(times[next] > budget) over--;
+        total -= times[next];
+      } else used++;
+
+      times[next] = ms;
+      buckets[bucket(ms)]++;
+      if(ms > budget) over++;
+      total += ms;
+      next = (next + 1) % WINDOW;
+    };
+
+    /*!
+     * \brief Get a percentile of the frame times.
+     * \param p Percentile from 0 to 100.
+     * \return Upper edge of the bucket the percentile is in, at most the max, in milliseconds.
+     */
+    float percentile(const float& p) const {
+      if(used == 0) return 0.0f;
+      //  Nearest rank.
+      const std::size_t rank = std::max(
+        static_cast<std::size_t>(std::ceil(std::clamp(p, 0.0f, 100.0f) / 100.0f * used)), (std::size_t)1);
+      std::size_t seen = 0;
+      for(std::size_t i = 0; i < BUCKETS; i++) {
+        seen += buckets[i];
+        if(seen >= rank) return (i == BUCKETS - 1 ? max() : std::min((i + 1) * BUCKET_MS, max()));
+      }
+      return max();
+    };
+
+    /*!
+     * \brief Get the longest frame time in the window.
+     * \return Time in milliseconds.
+     */
+    float max(void) const {
+      return (used == 0 ? 0.0f : *std::max_element(times.begin(), times.begin() + used));
+    };
+
+    /*!
+     * \brief Get the frames per second over the window.
+     * \return Frames per second.
+     */
+    float fps(void) const {
+      return (total > 0.0 ? static_cast<float>(used * 1000.0 / total) : 0.0f);
+    };
+
+    /*!
+     * \brief Get the number of frames in the window.
+     * \return Frame count.
+     */
+    std::size_t count(void) const { return used; };
+
+    /*!
+     * \brief Get the number of frames in the window over budget.
+     * \return Frame count.
+     */
+    std::size_t over_budget(void) const { return over; };
+
+    /*!
+     * \brief Get the frame time budget.
+     * \return Budget in milliseconds.
+     */
+    float get_budget(void) const { return budget; };
+
+    /*!
+     * \brief Set the frame time budget.  Recounts the frames over budget.
+     * \param ms Budget in milliseconds.
+     */
+    void set_budget(const float& ms) {
+      budget = ms;
+      over = std::count_if(times.begin(), times.begin() + used, [this](const float& t){ return t > budget; });
+    };
+
+    /*!
+     * \brief Append a summary of the frame times to a CSV file.
+     *
+     * Writes a header first if the file is empty.  Columns are the unix time,
+     * frame count, fps, p50, p95, p99 and max in milliseconds, budget and frames over budget.
+     *
+     * \param fname File to write to.
+     * \return False on fail, true on success.
+     */
+    bool save_csv(const std::string& fname) const {
+      bool empty;
+      {
+        std::ifstream check(fname);
+        empty = (!check.good() || check.peek() == EOF);
+      }
+      std::ofstream dfile(fname, std::ofstream::app);
+      if(!dfile.good()) return false;
+      if(empty)
+        dfile << "time,frames,fps,p50_ms,p95_ms,p99_ms,max_ms,budget_ms,over_budget\n";
+      dfile << std::time(nullptr) << "," << used << "," << fps() << "," <<
+        percentile(50.0f) << "," << percentile(95.0f) << "," << percentile(99.0f) << "," <<
+        max() << "," << budget << "," << over << "\n";
+      const bool ok = dfile.good();
+      dfile.close();
+      return ok;
+    };
+
+  private:
+    //  Bucket of a frame time.
+    static std::size_t bucket(const float& ms) {
+      if(ms <= 0.0f) return 0;
+      return std::min(static_cast<std::size_t>(ms / BUCKET_MS), BUCKETS - 1);
+    };
+
+    inline static const std::size_t WINDOW = 600;   //  Frames kept.
+    inline static const std::size_t BUCKETS = 1000;  //  Histogram buckets.
+    inline static const float BUCKET_MS = 0.1f;      //  Width of a bucket in milliseconds.
+
+    float budget;                              //  Frame time budget in milliseconds.
+    std::array<float, WINDOW> times;           //  Frame times, oldest at next once full.
+    std::array<std::size_t, BUCKETS> buckets;  //  Histogram of the frame times.
+    std::size_t next;                          //  Where the next time is written.
+    std::size_t used;                          //  Frames in the window.
+    std::size_t over;                          //  Frames in the window over budget.
+    double total;                              //  Sum of the frame times.
+};
+
+}  //  end namespace wte
+
+#endif
@@ -41,6 +41,34 @@
   #define WTE_OPENGL_LATEST FALSE
 #endif
 
+//  Use fixed point numbers for the simulation components.
+#if defined(WTE_FIXED_POINT)
+  #define WTE_USE_FIXED_POINT TRUE
+#else
+  #define WTE_USE_FIXED_POINT FALSE
+#endif
+
+//  Enable coroutine AI when the compiler supports it.
+#if defined(__cpp_impl_coroutine) && !defined(WTE_DISABLE_COROUTINES)
+  #define WTE_USE_COROUTINES TRUE
+#else
+  #define WTE_USE_COROUTINES FALSE
+#endif
+
+//  Draw on a separate render thread.  Not available with Emscripten.
+#if defined(WTE_RENDER_THREAD) && !defined(__EMSCRIPTEN__)
+  #define WTE_USE_RENDER_THREAD TRUE
+#else
+  #define WTE_USE_RENDER_THREAD FALSE
+#endif
+
+//  Draw to memory bitmaps without a display.
+#if defined(WTE_HEADLESS)
+  #define WTE_USE_HEADLESS TRUE
+#else
+  #define WTE_USE_HEADLESS FALSE
+#endif
+
 //  Set the timer rate.
 //  Number of ticks per second as a float.
 #if !defined(WTE_TICKS_PER_SECOND)
@@ -88,6 +116,10 @@ namespace wte {
 struct wte_build_options {
   inline constexpr static bool debug_mode = static_cast<bool>(WTE_DEBUG_MODE);
   inline constexpr static bool opengl_latest = static_cast<bool>(WTE_OPENGL_LATEST);
+  inline constexpr static bool fixed_point = static_cast<bool>(WTE_USE_FIXED_POINT);
+  inline constexpr static bool coroutines = static_cast<bool>(WTE_USE_COROUTINES);
+  inline constexpr static bool render_thread = static_cast<bool>(WTE_USE_RENDER_THREAD);
+  inline constexpr static bool headless = static_cast<bool>(WTE_USE_HEADLESS);
   inline constexpr static float ticks_per_sec = static_cast<float>(WTE_TICKS_PER_SECOND);
   inline constexpr static int max_playing_samples = static_cast<int>(WTE_MAX_PLAYING_SAMPLES);
 
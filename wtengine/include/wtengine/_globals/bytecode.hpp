@@ -0,0 +1,234 @@
+/*
+ * wtengine
+ * --------
+ * By Matthew Evans
+ * See LICENSE.md for copyright information.
+ */
+
+#if !defined(WTE_BYTECODE_HPP)
+#define WTE_BYTECODE_HPP
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <utility>
+#include <cstdint>
+#include <cstdlib>
+
+#include "wtengine/_debug/exceptions.hpp"
+
+namespace wte::bytecode {
+
+/*!
+ * \enum opcode
+ * \brief Behavior program instructions.
+ */
+enum class opcode : uint8_t {
+  nop, end, li, mov, ld, st, ldv, stv,
+  add, sub, mul, div, min, max, addi, muli,
+  neg, abs, sqrt, sin, cos, floor,
+  lt, le, eq, ne,
+  jmp, jz, jnz,
+  tick, rand, send
+};
+
+/*!
+ * \enum field
+ * \brief Component fields a behavior program can read and write.
+ */
+enum class field : uint8_t {
+  pos_x, pos_y,
+  direction, x_vel, y_vel,
+  accel_x, accel_y, drag, max_speed, mass,
+  width, height, solid
+};
+
+/*!
+ * \struct instruction
+ * \brief A single behavior program instruction.
+ *
+ * a, b and c are registers.  i is a field, var, jump target or send index.
+ */
+struct instruction {
+  opcode op;       //!<  Instruction.
+  uint8_t a, b, c; //!<  Registers.
+  int32_t i;       //!<  Field, var, jump target or send index.
+  float imm;       //!<  Immediate value.
+};
+
+/*!
+ * \struct send_args
+ * \brief Message sent by a send instruction.
+ *
+ * A to of $self is replaced by the entity's name.
+ */
+struct send_args {
+  std::string sys, to, cmd, args;  //!<  Message values.
+};
+
+/*!
+ * \struct program
+ * \brief A compiled behavior program.
+ */
+struct program {
+  std::vector<instruction> code;  //!<  Instructions.
+  std::vector<send_args> sends;   //!<  Messages used by send instructions.
+};
+
+inline constexpr std::size_t REGISTERS = 16;  //!<  Registers per program run.
+inline constexpr std::size_t VARS = 8;        //!<  Vars stored per entity.
+
+/*!
+ * \brief Compile behavior program source.
+ *
+ * One instruction per line.  Text after # is a comment.  A word ending with : is a label.
+ *
+ * \code
+ * li r0 0.5
+ * ld r1 location.pos_x
+ * add r1 r1 r0
+ * st location.pos_x r1
+ * \endcode
+ *
+ * \param src Program source.
+ * \return The compiled program.
+ * \exception engine_exception Thrown on a bad instruction.
+ */
+inline program assemble(const std::string& src) {
+  static const std::map<std::string, opcode> ops = {
+    { "nop", opcode::nop }, { "end", opcode::end }, { "li", opcode::li }, { "mov", opcode::mov },
+    { "ld", opcode::ld }, { "st", opcode::st }, { "ldv", opcode::ldv }, { "stv", opcode::stv },
+    { "add", opcode::add }, { "sub", opcode::sub }, { "mul", opcode::mul }, { "div", opcode::div },
+    { "min", opcode::min }, { "max", opcode::max }, { "addi", opcode::addi }, { "muli", opcode::muli },
+    { "neg", opcode::neg }, { "abs", opcode::abs }, { "sqrt", opcode::sqrt }, { "sin", opcode::sin },
+    { "cos", opcode::cos }, { "floor", opcode::floor }, { "lt", opcode::lt }, { "le", opcode::le },
+    { "eq", opcode::eq }, { "ne", opcode::ne }, { "jmp", opcode::jmp }, { "jz", opcode::jz },
+    { "jnz", opcode::jnz }, { "tick", opcode::tick }, { "rand", opcode::rand }, { "send", opcode::send }
+  };
+  static const std::map<std::string, field> fields = {
+    { "location.pos_x", field::pos_x }, { "location.pos_y", field::pos_y },
+    { "motion.direction", field::direction }, { "motion.x_vel", field::x_vel },
+    { "motion.y_vel", field::y_vel }, { "physics.accel_x", field::accel_x },
+    { "physics.accel_y", field::accel_y }, { "physics.drag", field::drag },
+    { "physics.max_speed", field::max_speed }, { "physics.mass", field::mass },
+    { "hitbox.width", field::width }, { "hitbox.height", field::height },
+    { "hitbox.solid", field::solid }
+  };
+
+  program prog;
+  std::map<std::string, int32_t> labels;
+  std::vector<std::pair<std::size_t, std::string>> jumps;  //  Resolved after all labels are found.
+  std::istringstream lines(src);
+  std::string line;
+  std::size_t line_num = 0;
+
+  while(std::getline(lines, line)) {
+    line_num++;
+    const std::size_t comment = line.find('#');
+    if(comment != std::string::npos) line.erase(comment);
+
+    std::istringstream words(line);
+    std::string word;
+    if(!(words >> word)) continue;
+
+    auto fail = [&line_num](const std::string& what) {
+      throw engine_exception("Line " + std::to_string(line_num) + ": " + what, "Bytecode", 2);
+    };
+    auto reg = [&words, &fail]() -> uint8_t {
+      std::string r;
+      if(!(words >> r) || r.size() < 2 || r[0] != 'r') fail("Expected register");
+      char* end = nullptr;
+      const long n = std::strtol(r.c_str() + 1, &end, 10);
+      if(r[1] < '0' || r[1] > '9' || *end != '\0' || n >= (long)REGISTERS) fail("Bad register " + r);
+      return (uint8_t)n;
+    };
+    auto num = [&words, &fail]() -> float {
+      std::string n;
+      if(!(words >> n)) fail("Expected number");
+      char* end = nullptr;
+      const float v = std::strtof(n.c_str(), &end);
+      if(*end != '\0') fail("Bad number " + n);
+      return v;
+    };
+    auto fld = [&words, &fail]() -> int32_t {
+      std::string f;
+      words >> f;
+      auto it = fields.find(f);
+      if(it == fields.end()) fail("Bad field " + f);
+      return (int32_t)it->second;
+    };
+    auto var = [&num, &fail]() -> int32_t {
+      const int v = (int)num();
+      if(v < 0 || v >= (int)VARS) fail("Bad var");
+      return v;
+    };
+    auto label = [&words, &fail, &jumps, &prog]() {
+      std::string l;
+      if(!(words >> l)) fail("Expected label");
+      jumps.push_back(std::make_pair(prog.code.size(), l));
+    };
+
+    if(word.back() == ':') {
+      labels[word.substr(0, word.size() - 1)] = (int32_t)prog.code.size();
+      if(!(words >> word)) continue;
+    }
+
+    auto op_it = ops.find(word);
+    if(op_it == ops.end()) fail("Bad instruction " + word);
+    instruction ins = { op_it->second, 0, 0, 0, 0, 0.0f };
+
+    switch(ins.op) {
+      case opcode::li:
+        ins.a = reg(); ins.imm = num(); break;
+      case opcode::mov: case opcode::neg: case opcode::abs: case opcode::sqrt:
+      case opcode::sin: case opcode::cos: case opcode::floor:
+        ins.a = reg(); ins.b = reg(); break;
+      case opcode::ld:
+        ins.a = reg(); ins.i = fld(); break;
+      case opcode::st:
+        ins.i = fld(); ins.a = reg(); break;
+      case opcode::ldv:
+        ins.a = reg(); ins.i = var(); break;
+      case opcode::stv:
+        ins.i = var(); ins.a = reg(); break;
+      case opcode::add: case opcode::sub: case opcode::mul: case opcode::div:
+      case opcode::min: case opcode::max: case opcode::lt: case opcode::le:
+      case opcode::eq: case opcode::ne:
+        ins.a = reg(); ins.b = reg(); ins.c = reg(); break;
+      case opcode::addi: case opcode::muli:
+        ins.a = reg(); ins.b = reg(); ins.imm = num(); break;
+      case opcode::jmp:
+        label(); break;
+      case opcode::jz: case opcode::jnz:
+        ins.a = reg(); label(); break;
+      case opcode::tick: case opcode::rand:
+        ins.a = reg(); break;
+      case opcode::send: {
+        //  send sys to cmd [args]
+        send_args s;
+        if(!(words >> s.sys >> s.to >> s.cmd)) fail("Expected sys, to and cmd");
+        std::getline(words >> std::ws, s.args);
+        ins.i = (int32_t)prog.sends.size();
+        prog.sends.push_back(s);
+        break;
+      }
+      default:
+        break;
+    }
+    if(words >> word) fail("Unexpected " + word);
+    prog.code.push_back(ins);
+  }
+
+  for(auto& it: jumps) {
+    auto l_it = labels.find(it.second);
+    if(l_it == labels.end()) throw engine_exception("Unknown label " + it.second, "Bytecode", 2);
+    prog.code[it.first].i = l_it->second;
+  }
+  prog.code.push_back({ opcode::end, 0, 0, 0, 0, 0.0f });
+  return prog;
+};
+
+}  //  end namespace wte::bytecode
+
+#endif
@@ -0,0 +1,435 @@
+/*
+ * wtengine
+ * --------
+ * By Matthew Evans
+ * See LICENSE.md for copyright information.
+ */
+
+#if !defined(WTE_FIXED_POINT_HPP)
+#define WTE_FIXED_POINT_HPP
+
+#include <cstdint>
+#include <cmath>
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#include "wtengine/_globals/_defines.hpp"
+
+namespace wte {
+
+/*!
+ * \class fixed
+ * \brief Signed 16.16 fixed point number.
+ *
+ * Gives the same results on any compiler or optimization level.
+ * Converts from any arithmetic type, and to float for drawing.
+ * Results that do not fit are saturated.
+ */
+class fixed final {
+  public:
+    /*!
+     * \brief Create a fixed point number set to zero.
+     */
+    constexpr fixed() : raw(0) {};
+
+    /*!
+     * \brief Create a fixed point number from an arithmetic type.
+     * \param v Value to convert.
+     */
+    template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+    constexpr fixed(const T& v) : raw(to_raw(v)) {};
+
+    /*!
+     * \brief Create a fixed point number from its raw value.
+     * \param r Raw value.
+     * \return Fixed point number.
+     */
+    static constexpr fixed from_raw(const int32_t& r) {
+      fixed temp;
+      temp.raw = r;
+      return temp;
+    };
+
+    /*!
+     * \brief Get the raw value.
+     * \return Raw value.
+     */
+    constexpr int32_t get_raw(void) const { return raw; };
+
+    /*!
+     * \brief Convert to float.
+     */
+    constexpr operator float() const { return static_cast<float>(raw) / ONE; };
+
+    constexpr fixed operator-() const { return from_raw(saturate(-static_cast<int64_t>(raw))); };
+    constexpr fixed operator+() const { return *this; };
+
+    constexpr fixed& operator+=(const fixed& v) { raw = saturate(static_cast<int64_t>(raw) + v.raw); return *this; };
+    constexpr fixed& operator-=(const fixed& v) { raw = saturate(static_cast<int64_t>(raw) - v.raw); return *this; };
+    constexpr fixed& operator*=(const fixed& v) { raw = saturate((static_cast<int64_t>(raw) * v.raw) >> FRAC_BITS); return *this; };
+    constexpr fixed& operator/=(const fixed& v) {
+      if(v.raw == 0) raw = (raw < 0 ? std::numeric_limits<int32_t>::min() : std::numeric_limits<int32_t>::max());
+      else raw = saturate((static_cast<int64_t>(raw) * ONE) / v.raw);
+      return *this;
+    };
+
+    friend constexpr fixed operator+(fixed a, const fixed& b) { return a += b; };
+    friend constexpr fixed operator-(fixed a, const fixed& b) { return a -= b; };
+    friend constexpr fixed operator*(fixed a, const fixed& b) { return a *= b; };
+    friend constexpr fixed operator/(fixed a, const fixed& b) { return a /= b; };
+
+    friend constexpr bool operator==(const fixed& a, const fixed& b) { return a.raw == b.raw; };
+    friend constexpr bool operator!=(const fixed& a, const fixed& b) { return a.raw != b.raw; };
+    friend constexpr bool operator<(const fixed& a, const fixed& b) { return a.raw < b.raw; };
+    friend constexpr bool operator>(const fixed& a, const fixed& b) { return a.raw > b.raw; };
+    friend constexpr bool operator<=(const fixed& a, const fixed& b) { return a.raw <= b.raw; };
+    friend constexpr bool operator>=(const fixed& a, const fixed& b) { return a.raw >= b.raw; };
+
+    inline static constexpr int FRAC_BITS = 16;         //!<  Number of fraction bits.
+    inline static constexpr int32_t ONE = 1 << FRAC_BITS;  //!<  Raw value of one.
+
+  private:
+    //  Limit a result to the raw range.
+    static constexpr int32_t saturate(const int64_t& v) {
+      if(v > std::numeric_limits<int32_t>::max()) return std::numeric_limits<int32_t>::max();
+      if(v < std::numeric_limits<int32_t>::min()) return std::numeric_limits<int32_t>::min();
+      return static_cast<int32_t>(v);
+    };
+
+    //  Convert an arithmetic value to raw, rounding to nearest.
+    template <typename T>
+    static constexpr int32_t to_raw(const T& v) {
+      if constexpr(std::is_integral<T>::value) {
+        return saturate(static_cast<int64_t>(v) * ONE);
+      } else {
+        const double temp = static_cast<double>(v) * ONE;
+        if(!(temp == temp)) return 0;  //  NaN
+        if(temp >= std::numeric_limits<int32_t>::max()) return std::numeric_limits<int32_t>::max();
+        if(temp <= std::numeric_limits<int32_t>::min()) return std::numeric_limits<int32_t>::min();
+        return static_cast<int32_t>(temp < 0 ? temp - 0.5 : temp + 0.5);
+      }
+    };
+
+    int32_t raw;
+};
+
+/*
+ * Mixed operators, the arithmetic value is converted to fixed first.
+ */
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr fixed operator+(const fixed& a, const T& b) { return a + fixed(b); };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr fixed operator+(const T& a, const fixed& b) { return fixed(a) + b; };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr fixed operator-(const fixed& a, const T& b) { return a - fixed(b); };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr fixed operator-(const T& a, const fixed& b) { return fixed(a) - b; };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr fixed operator*(const fixed& a, const T& b) { return a * fixed(b); };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr fixed operator*(const T& a, const fixed& b) { return fixed(a) * b; };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr fixed operator/(const fixed& a, const T& b) { return a / fixed(b); };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr fixed operator/(const T& a, const fixed& b) { return fixed(a) / b; };
+
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr fixed& operator+=(fixed& a, const T& b) { return a += fixed(b); };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr fixed& operator-=(fixed& a, const T& b) { return a -= fixed(b); };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr fixed& operator*=(fixed& a, const T& b) { return a *= fixed(b); };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr fixed& operator/=(fixed& a, const T& b) { return a /= fixed(b); };
+
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr bool operator==(const fixed& a, const T& b) { return a == fixed(b); };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr bool operator==(const T& a, const fixed& b) { return fixed(a) == b; };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr bool operator!=(const fixed& a, const T& b) { return a != fixed(b); };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr bool operator!=(const T& a, const fixed& b) { return fixed(a) != b; };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr bool operator<(const fixed& a, const T& b) { return a < fixed(b); };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr bool operator<(const T& a, const fixed& b) { return fixed(a) < b; };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr bool operator>(const fixed& a, const T& b) { return a > fixed(b); };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr bool operator>(const T& a, const fixed& b) { return fixed(a) > b; };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr bool operator<=(const fixed& a, const T& b) { return a <= fixed(b); };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr bool operator<=(const T& a, const fixed& b) { return fixed(a) <= b; };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr bool operator>=(const fixed& a, const T& b) { return a >= fixed(b); };
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+constexpr bool operator>=(const T& a, const fixed& b) { return fixed(a) >= b; };
+
+/*!
+ * \typedef sim_float
+ * Number type used by the simulation components.
+ * Fixed point when built with WTE_FIXED_POINT, float otherwise.
+ */
+#if WTE_USE_FIXED_POINT
+using sim_float = fixed;
+#else
+using sim_float = float;
+#endif
+
+/*!
+ * \namespace sim_math
+ * \brief Math functions for sim_float.
+ *
+ * The fixed point versions use a sine table that is built at compile time,
+ * so they give the same results on any platform.
+ */
+namespace sim_math {
+
+/*
+ * Build the sine table at compile time.
+ */
+namespace detail {
+  inline constexpr int SINE_BITS = 10;                //  Table has 1024 entries per turn.
+  inline constexpr int SINE_SIZE = 1 << SINE_BITS;
+  inline constexpr double PI = 3.141592653589793238462643383279502884;
+
+  //  Taylor series sine, x must be between -PI and PI.
+  constexpr double taylor_sin(const double& x) {
+    double term = x, sum = x;
+    for(int n = 1; n < 20; n++) {
+      term *= -x * x / ((2 * n) * (2 * n + 1));
+      sum += term;
+    }
+    return sum;
+  };
+
+  constexpr std::array<int32_t, SINE_SIZE> make_sine_table(void) {
+    std::array<int32_t, SINE_SIZE> table{};
+    for(int i = 0; i < SINE_SIZE; i++) {
+      double x = 2.0 * PI * i / SINE_SIZE;
+      if(x > PI) x -= 2.0 * PI;
+      const double v = taylor_sin(x) * fixed::ONE;
+      table[i] = static_cast<int32_t>(v < 0 ? v - 0.5 : v + 0.5);
+    }
+    return table;
+  };
+
+  inline constexpr std::array<int32_t, SINE_SIZE> sine_table = make_sine_table();
+
+  //  Raw value of table entries per radian.
+  inline constexpr int64_t TABLE_SCALE =
+    static_cast<int64_t>(SINE_SIZE / (2.0 * PI) * fixed::ONE + 0.5);
+}
+
+/*!
+ * \brief Sine of a fixed point angle, using the sine table.
+ * \param a Angle in radians.
+ * \return Sine of the angle.
+ */
+inline fixed sin(const fixed& a) {
+  //  Angle in table entries, 16.16.
+  const int64_t t = (static_cast<int64_t>(a.get_raw()) * detail::TABLE_SCALE) >> fixed::FRAC_BITS;
+  const int32_t idx = static_cast<int32_t>(t >> fixed::FRAC_BITS) & (detail::SINE_SIZE - 1);
+  const int64_t frac = t & (fixed::ONE - 1);
+  const int32_t s0 = detail::sine_table[idx];
+  const int32_t s1 = detail::sine_table[(idx + 1) & (detail::SINE_SIZE - 1)];
+  //  Interpolate between the entries.
+  return fixed::from_raw(s0 + static_cast<int32_t>(((s1 - s0) * frac) >> fixed::FRAC_BITS));
+};
+
+/*!
+ * \brief Cosine of a fixed point angle, using the sine table.
+ * \param a Angle in radians.
+ * \return Cosine of the angle.
+ */
+inline fixed cos(const fixed& a) {
+  return sin(a + fixed::from_raw(static_cast<int32_t>(detail::PI / 2.0 * fixed::ONE + 0.5)));
+};
+
+/*!
+ * \brief Square root of a fixed point number.
+ * \param v Number to get the square root of.  Negative numbers return zero.
+ * \return Square root.
+ */
+inline fixed sqrt(const fixed& v) {
+  if(v.get_raw() <= 0) return fixed();
+  //  Integer square root of the raw value shifted up, so the result is 16.16.
+  uint64_t n = static_cast<uint64_t>(v.get_raw()) << fixed::FRAC_BITS;
+  uint64_t res = 0;
+  uint64_t bit = static_cast<uint64_t>(1) << 62;
+  while(bit > n) bit >>= 2;
+  while(bit != 0) {
+    if(n >= res + bit) {
+      n -= res + bit;
+      res = (res >> 1) + bit;
+    } else {
+      res >>= 1;
+    }
+    bit >>= 2;
+  }
+  return fixed::from_raw(static_cast<int32_t>(res));
+};
+
+/*!
+ * \brief Root of a fixed point number.
+ *
+ * Finds the largest result whose n-th power is at most the number by bisection.
+ * Powers are kept with 30 fraction bits, so small numbers keep their precision.
+ *
+ * \param v Number to get the root of.  Negative numbers return zero.
+ * \param n Degree of the root, one or more.
+ * \return The n-th root.
+ */
+inline fixed root(const fixed& v, const std::size_t& n) {
+  if(v.get_raw() <= 0 || n == 0) return fixed();
+  if(n == 1) return v;
+  const int EXTRA_BITS = 30 - fixed::FRAC_BITS;
+  const uint64_t target = static_cast<uint64_t>(v.get_raw()) << EXTRA_BITS;
+  //  Check if y to the power of n is at most v.  The power only grows when y is one or more.
+  auto fits = [&target, &n](const uint64_t& y) {
+    uint64_t p = y << EXTRA_BITS;
+    for(std::size_t k = 1; k < n; k++) {
+      if(y >= static_cast<uint64_t>(fixed::ONE) && p > target) return false;
+      p = (p >> fixed::FRAC_BITS) * y + (((p & (fixed::ONE - 1)) * y) >> fixed::FRAC_BITS);
+    }
+    return p <= target;
+  };
+  uint64_t low = 0;
+  uint64_t high = std::max(static_cast<uint64_t>(v.get_raw()), static_cast<uint64_t>(fixed::ONE));
+  while(low < high) {
+    const uint64_t mid = (low + high + 1) / 2;
+    if(fits(mid)) low = mid;
+    else high = mid - 1;
+  }
+  return fixed::from_raw(static_cast<int32_t>(low));
+};
+
+/*!
+ * \brief Angle of a fixed point vector.
+ *
+ * Uses a polynomial for the arc tangent, accurate to about 0.0001 radians.
+ *
+ * \param y Y of the vector.
+ * \param x X of the vector.
+ * \return Angle in radians, from -PI to PI.
+ */
+inline fixed atan2(const fixed& y, const fixed& x) {
+  if(x == 0 && y == 0) return fixed();
+  const fixed abs_x = (x < 0 ? -x : x);
+  const fixed abs_y = (y < 0 ? -y : y);
+  //  Arc tangent of the smaller over the larger, so z is from 0 to 1.
+  const bool swap = abs_y > abs_x;
+  const fixed z = (swap ? abs_x / abs_y : abs_y / abs_x);
+  const fixed z2 = z * z;
+  fixed r = z * (fixed(0.9998660) + z2 * (fixed(-0.3302995) + z2 * (fixed(0.1801410) +
+                 z2 * (fixed(-0.0851330) + z2 * fixed(0.0208351)))));
+  if(swap) r = fixed(detail::PI / 2.0) - r;
+  if(x < 0) r = fixed(detail::PI) - r;
+  if(y < 0) r = -r;
+  return r;
+};
+
+/*!
+ * \brief Square root of a float.
+ * \param v Number to get the square root of.
+ * \return Square root.
+ */
+inline float sqrt(const float& v) { return std::sqrt(v); };
+
+/*!
+ * \brief Root of a float.
+ * \param v Number to get the root of.  Negative numbers return zero.
+ * \param n Degree of the root, one or more.
+ * \return The n-th root.
+ */
+inline float root(const float& v, const std::size_t& n) {
+  if(v <= 0.0f || n == 0) return 0.0f;
+  return (n == 1 ? v : std::pow(v, 1.0f / static_cast<float>(n)));
+};
+
+/*!
+ * \brief Angle of a float vector.
+ * \param y Y of the vector.
+ * \param x X of the vector.
+ * \return Angle in radians, from -PI to PI.
+ */
+inline float atan2(const float& y, const float& x) { return std::atan2(y, x); };
+
+/*!
+ * \brief Sine of a float angle.
+ * \param a Angle in radians.
+ * \return Sine of the angle.
+ */
+inline float sin(const float& a) { return std::sin(a); };
+
+/*!
+ * \brief Cosine of a float angle.
+ * \param a Angle in radians.
+ * \return Cosine of the angle.
+ */
+inline float cos(const float& a) { return std::cos(a); };
+
+}  //  end namespace sim_math
+
+}  //  end namespace wte
+
+/*
+ * Limits for the fixed point type.
+ * There is no infinity, the max value is used instead.
+ * The class-key matches the standard library's declaration, libstdc++ uses struct.
+ */
+#if defined(__GLIBCXX__)
+  #define WTE_LIMITS_CLASS_KEY struct
+#else
+  #define WTE_LIMITS_CLASS_KEY class
+#endif
+
+namespace std {
+
+template <>
+WTE_LIMITS_CLASS_KEY numeric_limits<wte::fixed> {
+  public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = true;
+    static constexpr bool has_infinity = false;
+    static constexpr bool has_quiet_NaN = false;
+    static constexpr bool has_signaling_NaN = false;
+    static constexpr float_denorm_style has_denorm = denorm_absent;
+    static constexpr bool has_denorm_loss = false;
+    static constexpr float_round_style round_style = round_indeterminate;
+    static constexpr bool is_iec559 = false;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = false;  //  Saturates.
+    static constexpr int digits = 31;
+    static constexpr int digits10 = 9;
+    static constexpr int max_digits10 = 0;
+    static constexpr int radix = 2;
+    static constexpr int min_exponent = 0;
+    static constexpr int min_exponent10 = 0;
+    static constexpr int max_exponent = 0;
+    static constexpr int max_exponent10 = 0;
+    static constexpr bool traps = false;
+    static constexpr bool tinyness_before = false;
+
+    static constexpr wte::fixed min() noexcept { return wte::fixed::from_raw(1); };
+    static constexpr wte::fixed max() noexcept { return wte::fixed::from_raw(numeric_limits<int32_t>::max()); };
+    static constexpr wte::fixed lowest() noexcept { return wte::fixed::from_raw(numeric_limits<int32_t>::min()); };
+    static constexpr wte::fixed epsilon() noexcept { return wte::fixed::from_raw(1); };
+    static constexpr wte::fixed round_error() noexcept { return wte::fixed::from_raw(1); };
+    static constexpr wte::fixed infinity() noexcept { return max(); };
+    static constexpr wte::fixed quiet_NaN() noexcept { return wte::fixed(); };
+    static constexpr wte::fixed signaling_NaN() noexcept { return wte::fixed(); };
+    static constexpr wte::fixed denorm_min() noexcept { return min(); };
+};
+
+}  //  end namespace std
+
+#undef WTE_LIMITS_CLASS_KEY
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * wtengine
+ * --------
+ * By Matthew Evans
+ * See LICENSE.md for copyright information.
+ */
+
+#if !defined(WTE_THREAD_POOL_HPP)
+#define WTE_THREAD_POOL_HPP
+
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace wte {
+
+/*!
+ * \class thread_pool
+ * \brief Workers kept between runs for splitting work across threads.
+ *
+ * Workers are started the first time they are needed and wait for the next run
+ * between runs, so each run only wakes them instead of creating threads.
+ * The calling thread does the first part of the work.
+ */
+class thread_pool final {
+  public:
+    thread_pool() : task(nullptr), task_count(0), generation(0), pending(0), stopping(false) {};
+
+    ~thread_pool() {
+      {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        stopping = true;
+      }
+      start_signal.notify_all();
+      for(auto& it: workers) it.join();
+    };
+
+    thread_pool(const thread_pool&) = delete;       //  Delete copy constructor.
+    void operator=(thread_pool const&) = delete;  //  Delete assignment operator.
+
+    /*!
+     * \brief Call a function once for each part of the work and wait for all parts to finish.
+     * \param count Number of parts.  Uses this many threads, including the calling thread.
+     * \param func Function to call with the part number, from 0 to count - 1.
+     */
+    void run(const std::size_t& count, const std::function<void(const std::size_t&)>& func) {
+      if(count == 0) return;
+      if(count == 1) {
+        func(0);
+        return;
+      }
+      {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        while(workers.size() < count - 1)
+          workers.emplace_back(&thread_pool::work, this, workers.size() + 1, generation);
+        task = &func;
+        task_count = count;
+        pending = count - 1;
+        generation++;
+      }
+      start_signal.notify_all();
+      func(0);
+
+      std::unique_lock<std::mutex> lock(pool_mutex);
+      done_signal.wait(lock, [this]{ return pending == 0; });
+      task = nullptr;
+    };
+
+    /*!
+     * \brief Get the number of workers started.
+     * \return Worker count, not including the calling thread.
+     */
+    std::size_t size(void) const { return workers.size(); };
+
+  private:
+    //  Wait for each run and do the part matching the worker number.
+    void work(const std::size_t index, std::size_t seen) {
+      std::unique_lock<std::mutex> lock(pool_mutex);
+      while(true) {
+        start_signal.wait(lock, [this, &seen]{ return stopping || generation != seen; });
+        if(stopping) return;
+        seen = generation;
+        if(index >= task_count) continue;  //  Not needed for this run.
+
+        const std::function<void(const std::size_t&)>* func = task;
+        lock.unlock();
+        (*func)(index);
+        lock.lock();
+        if(--pending == 0) done_signal.notify_one();
+      }
+    };
+
+    std::vector<std::thread> workers;  //  Started workers.
+    std::mutex pool_mutex;             //  Guards the run state.
+    std::condition_variable start_signal;  //  Wakes the workers for a run.
+    std::condition_variable done_signal;   //  Wakes the caller when the parts are done.
+
+    const std::function<void(const std::size_t&)>* task;  //  Function of the current run.
+    std::size_t task_count;  //  Parts in the current run.
+    std::size_t generation;  //  Changed for each run.
+    std::size_t pending;     //  Parts still running on workers.
+    bool stopping;           //  Set when the workers should exit.
+};
+
+}  //  end namespace wte
+
+#endif
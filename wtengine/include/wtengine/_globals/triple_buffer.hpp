@@ -0,0 +1,81 @@
+/*
+ * wtengine
+ * --------
+ * By Matthew Evans
+ * See LICENSE.md for copyright information.
+ */
+
+#if !defined(WTE_TRIPLE_BUFFER_HPP)
+#define WTE_TRIPLE_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+
+namespace wte {
+
+/*!
+ * \class triple_buffer
+ * \brief Pass values from one writer thread to one reader thread without locking.
+ *
+ * The writer fills the write buffer and publishes it.  The reader acquires the latest
+ * published buffer, and keeps reading it until a newer one is published.  Neither
+ * side waits on the other, and buffers are reused, so their memory is kept.
+ * \tparam T Type of the buffers.
+ */
+template <typename T>
+class triple_buffer final {
+  public:
+    triple_buffer() : shared(1), back(0), front(2) {};
+    ~triple_buffer() = default;
+
+    triple_buffer(const triple_buffer&) = delete;   //  Delete copy constructor.
+    void operator=(triple_buffer const&) = delete;  //  Delete assignment operator.
+
+    /*!
+     * \brief Get the buffer to write to.  Writer only.
+     * \return Buffer not used by the reader.
+     */
+    T& write_buffer(void) { return buffers[back]; };
+
+    /*!
+     * \brief Publish the write buffer.  Writer only.
+     */
+    void publish(void) {
+      back = shared.exchange(back | FRESH) & INDEX;
+    };
+
+    /*!
+     * \brief Take the latest published buffer if there is a new one.  Reader only.
+     * \return True if a new buffer was taken.
+     */
+    bool acquire(void) {
+      if(!(shared.load() & FRESH)) return false;
+      front = shared.exchange(front) & INDEX;
+      return true;
+    };
+
+    /*!
+     * \brief Check if a buffer was published since the last acquire.
+     * \return True if acquire would take a new buffer.
+     */
+    bool has_new(void) const { return (shared.load() & FRESH); };
+
+    /*!
+     * \brief Get the buffer to read from.  Reader only.
+     * \return Last acquired buffer.
+     */
+    const T& read_buffer(void) const { return buffers[front]; };
+
+  private:
+    inline static const unsigned int INDEX = 3;  //  Bits of the buffer index.
+    inline static const unsigned int FRESH = 4;  //  Set when the shared buffer has not been read.
+
+    std::array<T, 3> buffers;
+    std::atomic<unsigned int> shared;  //  Buffer passed between the threads.
+    unsigned int back;                 //  Buffer owned by the writer.
+    unsigned int front;                //  Buffer owned by the reader.
+};
+
+}  //  end namespace wte
+
+#endif
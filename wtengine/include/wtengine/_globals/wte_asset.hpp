@@ -11,6 +11,7 @@
 #include <string>
 #include <functional>
 #include <memory>
+#include <atomic>
 
 #include <allegro5/allegro.h>
 #include <allegro5/allegro_audio.h>
@@ -24,6 +25,13 @@ namespace wte {
 template <typename T>
 using wte_asset = std::shared_ptr<T>;
 
+/*!
+ * \brief Number of bitmaps created with make_asset.
+ *
+ * Used by the render thread to find new memory bitmaps to convert.
+ */
+inline std::atomic<std::size_t> bitmaps_created = 0;
+
 /*!
  * \brief Create an Allegro bitmap asset of size width x height.
  * \tparam ALLEGRO_BITMAP Allegro bitmap structure.
@@ -34,6 +42,7 @@ using wte_asset = std::shared_ptr<T>;
 template <typename ALLEGRO_BITMAP>
 inline static const wte_asset<ALLEGRO_BITMAP> make_asset(const int& w, const int& h) {
   std::shared_ptr<ALLEGRO_BITMAP> temp_ptr(al_create_bitmap(w, h), al_destroy_bitmap);
+  bitmaps_created++;
   return temp_ptr;
 };
 
@@ -94,6 +103,7 @@ inline static const wte_asset<T> make_asset(const std::string& fname) {
 
   if constexpr (std::is_same_v<T, ALLEGRO_BITMAP>) {
     std::shared_ptr<ALLEGRO_BITMAP> temp_ptr(al_load_bitmap(fname.c_str()), al_destroy_bitmap);
+    bitmaps_created++;
     return temp_ptr;
   }
 
@@ -9,13 +9,17 @@
 #define WTE_COMPONENTS_HPP
 
 #include "wtengine/cmp/ai.hpp"
+#include "wtengine/cmp/ai_coroutine.hpp"
 #include "wtengine/cmp/background.hpp"
+#include "wtengine/cmp/behavior.hpp"
 #include "wtengine/cmp/bounding_box.hpp"
 #include "wtengine/cmp/dispatcher.hpp"
 #include "wtengine/cmp/hitbox.hpp"
 #include "wtengine/cmp/location.hpp"
 #include "wtengine/cmp/motion.hpp"
 #include "wtengine/cmp/overlay.hpp"
+#include "wtengine/cmp/physics.hpp"
 #include "wtengine/cmp/sprite.hpp"
+#include "wtengine/cmp/steering.hpp"
 
 #endif
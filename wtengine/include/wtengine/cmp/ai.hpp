@@ -9,6 +9,7 @@
 #define WTE_CMP_AI_HPP
 
 #include <functional>
+#include <cstdint>
 
 #include "wtengine/cmp/component.hpp"
 
@@ -26,6 +27,9 @@ namespace wte::cmp {
  * \brief Tag components to be processed by the Logic system.
  * 
  * Allows functions to be created to define the enabled or disabled logic.
+ * Set the interval to run the logic every few ticks instead of every tick.
+ * When the logic system has a time budget, logic waiting longest runs first,
+ * then higher priority logic.
  */
 class ai final : public component {
   friend class sys::logic;
@@ -36,7 +40,8 @@ class ai final : public component {
      * \param func Function to define AI process.
      */
     ai(const std::function<void(const entity_id&)>& func) :
-      enabled(true), enabled_ai(func), disabled_ai([](const entity_id& e_id){}) {};
+      enabled(true), interval(1), priority(0),
+      enabled_ai(func), disabled_ai([](const entity_id& e_id){}), queued(-1), due_since(-1) {};
 
     /*!
      * \brief Create an AI component with enabled and disabled AI.
@@ -46,16 +51,21 @@ class ai final : public component {
     ai(
       const std::function<void(const entity_id&)>& func_a,
       const std::function<void(const entity_id&)>& func_b
-    ) : enabled(true), enabled_ai(func_a), disabled_ai(func_b) {};
+    ) : enabled(true), interval(1), priority(0),
+    enabled_ai(func_a), disabled_ai(func_b), queued(-1), due_since(-1) {};
 
     ai() = delete;    //  Delete default constructor.
     ~ai() = default;  //  Default destructor.
 
-    bool enabled;     //!<  Flag to enable or disable the entity.
+    bool enabled;          //!<  Flag to enable or disable the entity.
+    std::size_t interval;  //!<  Ticks between each run.  1 to run every tick.
+    std::size_t priority;  //!<  Higher priority runs first among AI due on the same tick.
 
   private:
     const std::function<void(const entity_id&)> enabled_ai;   //  AI to run when enabled.
     const std::function<void(const entity_id&)> disabled_ai;  //  AI to run when disabled.
+    int64_t queued;     //  Tick the AI was last queued to run.
+    int64_t due_since;  //  Tick the AI became due, kept while it is deferred.
 };
 
 }  //  end namespace wte::cmp
@@ -0,0 +1,221 @@
+/*
+ * wtengine
+ * --------
+ * By Matthew Evans
+ * See LICENSE.md for copyright information.
+ */
+
+#if !defined(WTE_CMP_AI_COROUTINE_HPP)
+#define WTE_CMP_AI_COROUTINE_HPP
+
+#include "wtengine/_globals/_defines.hpp"
+
+#if WTE_USE_COROUTINES
+
+#include <coroutine>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <cstdint>
+
+#include "wtengine/cmp/component.hpp"
+
+#include "wtengine/_globals/engine_time.hpp"
+#include "wtengine/_globals/message.hpp"
+#include "wtengine/mgr/world.hpp"
+
+namespace wte::sys {
+  class logic;
+}
+
+namespace wte::cmp {
+
+/*!
+ * \class ai_task
+ * \brief Coroutine type for coroutine AI.
+ *
+ * Return this from a coroutine and suspend it with co_await on
+ * wait_ticks, wait_message or wait_until.
+ */
+class ai_task final {
+  friend class sys::logic;
+
+  public:
+    /*!
+     * \enum wait_type
+     * \brief What a suspended task is waiting for.
+     */
+    enum class wait_type { none, ticks, message, until };
+
+    /*!
+     * \struct promise_type
+     * \brief Coroutine promise.  Stores what the task is waiting for.
+     */
+    struct promise_type {
+      ai_task get_return_object() {
+        return ai_task(std::coroutine_handle<promise_type>::from_promise(*this));
+      };
+      std::suspend_always initial_suspend() noexcept { return {}; };
+      std::suspend_always final_suspend() noexcept { return {}; };
+      void return_void() {};
+      void unhandled_exception() { throw; };
+
+      wait_type waiting = wait_type::none;   //!<  What the task is waiting for.
+      int64_t wake_tick = 0;                 //!<  Tick to wake on when waiting for ticks.
+      std::string wait_cmd;                  //!<  Command to wake on when waiting for a message.
+      std::function<bool(void)> wait_pred;   //!<  Condition to wake on when waiting until.
+      std::optional<message> received;       //!<  Message that woke the task.
+    };
+
+    ai_task(const ai_task&) = delete;
+    void operator=(const ai_task&) = delete;
+
+    /*!
+     * \brief Move a task.
+     * \param t Task to move.
+     */
+    ai_task(ai_task&& t) noexcept : handle(std::exchange(t.handle, nullptr)) {};
+
+    /*!
+     * \brief Move assign a task.
+     * \param t Task to move.
+     * \return This task.
+     */
+    ai_task& operator=(ai_task&& t) noexcept {
+      if(this != &t) {
+        if(handle) handle.destroy();
+        handle = std::exchange(t.handle, nullptr);
+      }
+      return *this;
+    };
+
+    ~ai_task() { if(handle) handle.destroy(); };
+
+    /*!
+     * \brief Check if the task has finished.
+     * \return True if finished, false if not.
+     */
+    bool done(void) const { return !handle || handle.done(); };
+
+  private:
+    explicit ai_task(std::coroutine_handle<promise_type> h) : handle(h) {};
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/*!
+ * \struct wait_ticks
+ * \brief Suspend a coroutine AI for a number of ticks.
+ */
+struct wait_ticks {
+  /*!
+   * \brief Wait for a number of ticks.
+   * \param n Ticks to wait.
+   */
+  explicit wait_ticks(const int64_t& n) : ticks(n) {};
+
+  bool await_ready(void) const noexcept { return ticks <= 0; };
+  void await_suspend(std::coroutine_handle<ai_task::promise_type> h) const {
+    h.promise().waiting = ai_task::wait_type::ticks;
+    h.promise().wake_tick = engine_time::check() + ticks;
+  };
+  void await_resume(void) const noexcept {};
+
+  const int64_t ticks;  //!<  Ticks to wait.
+};
+
+/*!
+ * \struct wait_message
+ * \brief Suspend a coroutine AI until its entity is sent a command.
+ *
+ * Resumes on the tick after the message is dispatched.  Returns the message.
+ */
+struct wait_message {
+  /*!
+   * \brief Wait for a command.
+   * \param c Command to wait for.
+   */
+  explicit wait_message(const std::string& c) : cmd(c) {};
+
+  bool await_ready(void) const noexcept { return false; };
+  void await_suspend(std::coroutine_handle<ai_task::promise_type> h) {
+    promise = &h.promise();
+    promise->waiting = ai_task::wait_type::message;
+    promise->wait_cmd = cmd;
+    promise->received.reset();
+  };
+  message await_resume(void) {
+    message temp_msg = *promise->received;
+    promise->received.reset();
+    return temp_msg;
+  };
+
+  const std::string cmd;  //!<  Command to wait for.
+
+  private:
+    ai_task::promise_type* promise = nullptr;
+};
+
+/*!
+ * \struct wait_until
+ * \brief Suspend a coroutine AI until a condition is true.
+ *
+ * The condition is checked once each tick.
+ */
+struct wait_until {
+  /*!
+   * \brief Wait until a condition is true.
+   * \param p Condition to check.
+   */
+  explicit wait_until(const std::function<bool(void)>& p) : pred(p) {};
+
+  bool await_ready(void) const { return pred(); };
+  void await_suspend(std::coroutine_handle<ai_task::promise_type> h) const {
+    h.promise().waiting = ai_task::wait_type::until;
+    h.promise().wait_pred = pred;
+  };
+  void await_resume(void) const noexcept {};
+
+  const std::function<bool(void)> pred;  //!<  Condition to wait for.
+};
+
+/*!
+ * \class ai_coroutine
+ * \brief Coroutine AI processed by the Logic system.
+ *
+ * The function is called once to start the coroutine.
+ * The coroutine is only resumed when what it is waiting for happens.
+ * Requires a compiler with C++20 coroutines.
+ */
+class ai_coroutine final : public component {
+  friend class sys::logic;
+
+  public:
+    /*!
+     * \brief Create a coroutine AI component.
+     * \param func Coroutine to run.  Passed the entity ID.
+     */
+    ai_coroutine(const std::function<ai_task(const entity_id&)>& func) :
+      routine(func), started(false) {};
+
+    ai_coroutine() = delete;    //  Delete default constructor.
+    ~ai_coroutine() = default;  //  Default destructor.
+
+    /*!
+     * \brief Check if the coroutine has finished.
+     * \return True if finished, false if not.
+     */
+    bool done(void) const { return started && (!task || task->done()); };
+
+  private:
+    const std::function<ai_task(const entity_id&)> routine;  //  Coroutine to start.
+    std::optional<ai_task> task;                             //  Running coroutine.
+    bool started;                                            //  Coroutine was started.
+};
+
+}  //  end namespace wte::cmp
+
+#endif  //  WTE_USE_COROUTINES
+
+#endif
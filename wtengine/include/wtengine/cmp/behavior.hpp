@@ -0,0 +1,44 @@
+/*
+ * wtengine
+ * --------
+ * By Matthew Evans
+ * See LICENSE.md for copyright information.
+ */
+
+#if !defined(WTE_CMP_BEHAVIOR_HPP)
+#define WTE_CMP_BEHAVIOR_HPP
+
+#include <string>
+#include <array>
+
+#include "wtengine/_globals/bytecode.hpp"
+#include "wtengine/cmp/component.hpp"
+
+namespace wte::cmp {
+
+/*!
+ * \class behavior
+ * \brief Run a behavior program each tick.  Processed by the Behaviors system.
+ *
+ * The program must be loaded in the programs manager.
+ * Vars keep their values between runs and can be set to pass values to the program.
+ */
+class behavior final : public component {
+  public:
+    /*!
+     * \brief Create a new Behavior component.
+     * \param p Name of the program to run.
+     */
+    behavior(const std::string& p) : program(p), enabled(true) { vars.fill(0.0f); };
+
+    behavior() = delete;    //  Delete default constructor.
+    ~behavior() = default;  //  Default destructor.
+
+    const std::string program;               //!<  Name of the program to run.
+    std::array<float, bytecode::VARS> vars;  //!<  Values stored between runs.
+    bool enabled;                            //!<  Run the program or not.
+};
+
+}  //  end namespace wte::cmp
+
+#endif
@@ -8,6 +8,7 @@
 #if !defined(WTE_CMP_BOUNDING_BOX_HPP)
 #define WTE_CMP_BOUNDING_BOX_HPP
 
+#include "wtengine/_globals/fixed_point.hpp"
 #include "wtengine/cmp/component.hpp"
 
 namespace wte::cmp {
@@ -28,19 +29,19 @@ class bounding_box final : public component {
      * \param ry Right Y
      */
     bounding_box(
-      const float& lx,
-      const float& ly,
-      const float& rx,
-      const float& ry
+      const sim_float& lx,
+      const sim_float& ly,
+      const sim_float& rx,
+      const sim_float& ry
     ) : min_x(lx), min_y(ly), max_x(rx), max_y(ry) {};
 
     bounding_box() = delete;    //  Delete default constructor.
     ~bounding_box() = default;  //  Default destructor.
 
-    float min_x;  //!<  Top left X position of bounding box.
-    float min_y;  //!<  Top left Y position of bounding box.
-    float max_x;  //!<  Bottom right X position of bounding box.
-    float max_y;  //!<  Bottom right Y position of bounding box.
+    sim_float min_x;  //!<  Top left X position of bounding box.
+    sim_float min_y;  //!<  Top left Y position of bounding box.
+    sim_float max_x;  //!<  Bottom right X position of bounding box.
+    sim_float max_y;  //!<  Bottom right Y position of bounding box.
 };
 
 }  //  end namespace wte::cmp
@@ -99,6 +99,9 @@ class gfx : public component {
     wte_asset<ALLEGRO_BITMAP> _bitmap;
 
   private:
+    //  Check if the animation function needs to run this tick.
+    virtual bool needs_update(void) { return true; };
+
     bool tinted;               //  Flag to set tint.
     ALLEGRO_COLOR tint_color;  //  Color of tint.
 
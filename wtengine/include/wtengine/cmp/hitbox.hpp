@@ -8,6 +8,7 @@
 #if !defined(WTE_CMP_HITBOX_HPP)
 #define WTE_CMP_HITBOX_HPP
 
+#include "wtengine/_globals/fixed_point.hpp"
 #include "wtengine/cmp/component.hpp"
 
 namespace wte::cmp {
@@ -15,6 +16,8 @@ namespace wte::cmp {
 /*!
  * \class hitbox
  * \brief Component to add a hitbox for performing colisions on.
+ * 
+ * Set the fast flag for entities that can move farther than their hitbox in one tick.
  */
 class hitbox final : public component {
   public:
@@ -25,10 +28,10 @@ class hitbox final : public component {
      * \param t Team value for the hitbox.
      */
     hitbox(
-      const float& w,
-      const float& h,
+      const sim_float& w,
+      const sim_float& h,
       const std::size_t& t
-    ) : width(w), height(h), team(t), solid(true) {};
+    ) : width(w), height(h), team(t), solid(true), fast(false) {};
 
     /*!
      * \brief Create a new Hitbox component, set solid flag.
@@ -38,19 +41,20 @@ class hitbox final : public component {
      * \param s Boolean value for if the hitbox is solid (enabled).
      */
     hitbox(
-      const float& w,
-      const float& h,
+      const sim_float& w,
+      const sim_float& h,
       const std::size_t& t,
       const bool& s
-    ) : width(w), height(h), team(t), solid(s) {};
+    ) : width(w), height(h), team(t), solid(s), fast(false) {};
 
     hitbox() = delete;    //  Delete default constructor.
     ~hitbox() = default;  //  Default destructor.
 
-    float width;       //!<  Width of the hitbox.
-    float height;      //!<  Height of the hitbox.
+    sim_float width;   //!<  Width of the hitbox.
+    sim_float height;  //!<  Height of the hitbox.
     std::size_t team;  //!<  Team number.
     bool solid;        //!<  Solid (enabled) flag.
+    bool fast;         //!<  Fast flag.  Enables swept colision testing.
 };
 
 }  //  end namespace wte::cmp
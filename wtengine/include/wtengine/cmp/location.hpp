@@ -8,6 +8,7 @@
 #if !defined(WTE_CMP_LOCATION_HPP)
 #define WTE_CMP_LOCATION_HPP
 
+#include "wtengine/_globals/fixed_point.hpp"
 #include "wtengine/cmp/component.hpp"
 
 namespace wte::cmp {
@@ -24,15 +25,15 @@ class location final : public component {
      * \param y Vertical location of the entity.
      */
     location(
-      const float& x,
-      const float& y
+      const sim_float& x,
+      const sim_float& y
     ) : pos_x(x), pos_y(y) {};
 
     location() = delete;    //  Delete default constructor.
     ~location() = default;  //  Default destructor.
 
-    float pos_x;  //!<  Entity X location.
-    float pos_y;  //!<  Entity Y location.
+    sim_float pos_x;  //!<  Entity X location.
+    sim_float pos_y;  //!<  Entity Y location.
 };
 
 } //  namespace wte::cmp
@@ -8,15 +8,34 @@
 #if !defined(WTE_CMP_MOTION_HPP)
 #define WTE_CMP_MOTION_HPP
 
+#include "wtengine/_globals/fixed_point.hpp"
 #include "wtengine/cmp/component.hpp"
 
+namespace wte::sys {
+  class movement;
+  class flocking;
+}
+
 namespace wte::cmp {
 
 /*!
  * \class motion
  * \brief Store motion information (velocity and direction) of an entity.
+ *
+ * The entity moves x_vel times the cosine of the direction on the X axis,
+ * and y_vel times the sine of the direction on the Y axis.
+ * Systems that write the velocity, such as physics and flocking, use set_velocity.
+ * This keeps the velocity vector, but sets the direction to its heading and
+ * both x_vel and y_vel to its speed.  Use get_velocity_x and get_velocity_y
+ * to read the velocity vector whatever form it is stored in.
+ *
+ * The unit vector of the direction is cached, and only recalculated when the direction changes.
+ * Uses the sim_math trig functions, so fixed point builds use the sine table.
  */
 class motion final : public component {
+  friend class wte::sys::movement;
+  friend class wte::sys::flocking;
+
   public:
     /*!
      * \brief Create a new Motion component with set direction and velocity.
@@ -25,17 +44,67 @@ class motion final : public component {
      * \param yv Y velocity.
      */
     motion(
-      const float& d,
-      const float& xv,
-      const float& yv
-    ) : direction(d), x_vel(xv), y_vel(yv) {};
+      const sim_float& d,
+      const sim_float& xv,
+      const sim_float& yv
+    ) : direction(d), x_vel(xv), y_vel(yv),
+    cached_direction(d), dir_x(sim_math::cos(d)), dir_y(sim_math::sin(d)) {};
 
     motion() = delete;    //  Delete default constructor.
     ~motion() = default;  //  Default destructor.
 
-    float direction;  //!<  Angle of direction.
-    float x_vel;      //!<  X velocity.
-    float y_vel;      //!<  Y velocity.
+    /*!
+     * \brief Set the direction and velocity from a velocity vector.
+     *
+     * Sets the direction to the heading of the vector and both the X and Y velocity
+     * to its speed.  Also sets the cached unit vector, so the direction is not
+     * recalculated next tick.  A zero vector keeps the direction.
+     *
+     * \param vx X part of the velocity.
+     * \param vy Y part of the velocity.
+     */
+    void set_velocity(const sim_float& vx, const sim_float& vy) {
+      const sim_float speed = sim_math::sqrt(vx * vx + vy * vy);
+      x_vel = speed;
+      y_vel = speed;
+      if(speed == 0) return;
+      direction = sim_math::atan2(vy, vx);
+      cached_direction = direction;
+      dir_x = vx / speed;
+      dir_y = vy / speed;
+    };
+
+    /*!
+     * \brief Get the X part of the velocity vector.
+     * \return X velocity times the cosine of the direction.
+     */
+    sim_float get_velocity_x(void) const {
+      return x_vel * (direction == cached_direction ? dir_x : sim_math::cos(direction));
+    };
+
+    /*!
+     * \brief Get the Y part of the velocity vector.
+     * \return Y velocity times the sine of the direction.
+     */
+    sim_float get_velocity_y(void) const {
+      return y_vel * (direction == cached_direction ? dir_y : sim_math::sin(direction));
+    };
+
+    sim_float direction;  //!<  Angle of direction.
+    sim_float x_vel;      //!<  Speed along the cosine of the direction.
+    sim_float y_vel;      //!<  Speed along the sine of the direction.
+
+  private:
+    //  Recalculate the unit vector if the direction changed.
+    void update_direction(void) {
+      if(direction == cached_direction) return;
+      cached_direction = direction;
+      dir_x = sim_math::cos(direction);
+      dir_y = sim_math::sin(direction);
+    };
+
+    sim_float cached_direction;  //  Direction the unit vector was calculated for.
+    sim_float dir_x, dir_y;      //  Unit vector of the direction.
 };
 
 }  //  end namespace wte::cmp
@@ -10,18 +10,25 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include <functional>
+#include <optional>
+#include <type_traits>
 
 #include <allegro5/allegro.h>
 #include <allegro5/allegro_font.h>
 
 #include "wtengine/cmp/gfx.hpp"
+#include "wtengine/mgr/variables.hpp"
 
 namespace wte::cmp::gfx {
 
 /*!
  * \class overlay
  * \brief Component for storing an overlay image and defining its animation process.
+ *
+ * By default the overlay is drawn every tick.  Once it watches a variable or a value
+ * it is retained, and only drawn when one of them changes or it is invalidated.
  */
 class overlay final : public gfx {
 
@@ -42,7 +49,7 @@ class overlay final : public gfx {
       const float& x,
       const float& y,
       const std::function<void(const entity_id&)>& func
-    ) : gfx(bmp, l, func), pos_x(x), pos_y(y), overlay_font(font) {};
+    ) : gfx(bmp, l, func), pos_x(x), pos_y(y), overlay_font(font), dirty(true) {};
 
     overlay() = delete;    //  Delete default constructor.
     ~overlay() = default;  //  Default destructor.
@@ -65,11 +72,67 @@ class overlay final : public gfx {
       al_draw_text(overlay_font.get(), color, x, y, f, txt.c_str());
     };
 
+    /*!
+     * \brief Redraw the overlay when a variable changes.
+     * \param var Name of the variable in the variables manager.
+     */
+    void watch(const std::string& var) {
+      watched_vars.push_back({ var, mgr::variables::get_version(var) });
+    };
+
+    /*!
+     * \brief Redraw the overlay when a value changes.
+     *
+     * The function is called each tick and its result compared to the last one,
+     * so it should be cheap, like reading a component field.
+     * \tparam F Function type, returning a value that can be compared with ==.
+     * \param func Function to get the value.
+     */
+    template <typename F>
+    void watch_value(F func) {
+      using T = std::decay_t<std::invoke_result_t<F>>;
+      watched_values.push_back([func, last = std::optional<T>()]() mutable {
+        T value = func();
+        if(last && *last == value) return false;
+        last = value;
+        return true;
+      });
+    };
+
+    /*!
+     * \brief Redraw the overlay next tick.
+     */
+    void invalidate(void) { dirty = true; };
+
     float pos_x;  //!<  X position.
     float pos_y;  //!<  Y position.
 
   private:
+    struct watched_var {
+      std::string name;
+      std::size_t version;
+    };
+
+    //  Check the watched variables and values.  Always true when nothing is watched.
+    bool needs_update(void) override {
+      if(watched_vars.empty() && watched_values.empty()) return true;
+      bool changed = dirty;
+      for(auto& it: watched_vars) {
+        const std::size_t version = mgr::variables::get_version(it.name);
+        if(it.version != version) changed = true;
+        it.version = version;
+      }
+      //  Call every function so they all keep their last value.
+      for(auto& it: watched_values) changed |= it();
+      dirty = false;
+      return changed;
+    };
+
     wte_asset<ALLEGRO_FONT> overlay_font;  //  Font for overlay.
+
+    bool dirty;                                        //  Redraw next check.
+    std::vector<watched_var> watched_vars;             //  Variables to redraw on.
+    std::vector<std::function<bool(void)>> watched_values;  //  Returns true when its value changed.
 };
 
 }  //  end namespace wte::cmp
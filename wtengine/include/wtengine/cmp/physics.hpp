@@ -0,0 +1,79 @@
+/*
+ * wtengine
+ * --------
+ * By Matthew Evans
+ * See LICENSE.md for copyright information.
+ */
+
+#if !defined(WTE_CMP_PHYSICS_HPP)
+#define WTE_CMP_PHYSICS_HPP
+
+#include "wtengine/_globals/fixed_point.hpp"
+#include "wtengine/cmp/component.hpp"
+
+namespace wte::sys {
+  class movement;
+}
+
+namespace wte::cmp {
+
+/*!
+ * \class physics
+ * \brief Store physics information (acceleration, drag and mass) of an entity.
+ *
+ * Used by the movement system with the motion component to update the velocity.
+ * Values are per tick.  The entity also needs a location and motion component.
+ */
+class physics final : public component {
+  friend class wte::sys::movement;
+
+  public:
+    /*!
+     * \brief Create a new Physics component with set mass.
+     * \param m Mass, used when applying forces.
+     */
+    physics(
+      const sim_float& m
+    ) : accel_x(0), accel_y(0), drag(0), max_speed(0), mass(m), force_x(0), force_y(0) {};
+
+    /*!
+     * \brief Create a new Physics component with set mass, drag and max speed.
+     * \param m Mass, used when applying forces.
+     * \param d Drag, the part of the velocity lost each tick.  From 0 to 1.
+     * \param s Max speed.  Zero for no limit.
+     */
+    physics(
+      const sim_float& m,
+      const sim_float& d,
+      const sim_float& s
+    ) : accel_x(0), accel_y(0), drag(d), max_speed(s), mass(m), force_x(0), force_y(0) {};
+
+    physics() = delete;    //  Delete default constructor.
+    ~physics() = default;  //  Default destructor.
+
+    /*!
+     * \brief Apply a force for the next tick.
+     *
+     * Forces are divided by the mass and added to the acceleration for one tick.
+     *
+     * \param fx X force.
+     * \param fy Y force.
+     */
+    void apply_force(const sim_float& fx, const sim_float& fy) {
+      force_x += fx;
+      force_y += fy;
+    };
+
+    sim_float accel_x;    //!<  X acceleration.
+    sim_float accel_y;    //!<  Y acceleration.
+    sim_float drag;       //!<  Part of the velocity lost each tick.
+    sim_float max_speed;  //!<  Max speed.  Zero for no limit.
+    sim_float mass;       //!<  Mass.
+
+  private:
+    sim_float force_x, force_y;  //  Forces applied this tick.
+};
+
+}  //  end namespace wte::cmp
+
+#endif
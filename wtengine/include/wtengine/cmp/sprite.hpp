@@ -11,6 +11,8 @@
 #include <string>
 #include <utility>
 #include <map>
+#include <vector>
+#include <algorithm>
 #include <stdexcept>
 
 #include <allegro5/allegro.h>
@@ -63,10 +65,10 @@ class sprite final : public gfx {
           if(current_frame > stop_frame) {
               current_frame = start_frame;
           }
-          //  Calculate the X position in the sprite sheet.
-          sprite_x = (float)((int)(current_frame * sprite_width + sheet_width) % sheet_width);
-          //  Calculate the Y position in the sprite sheet.
-          sprite_y = (float)((int)((current_frame * sprite_width) / sheet_width) * sprite_height);
+          //  Look up the position in the sprite sheet.
+          if(current_frame >= frames.size()) build_frames(current_frame);
+          sprite_x = frames[current_frame].x;
+          sprite_y = frames[current_frame].y;
         }
       }),
       sprite_width(sw), sprite_height(sh), draw_offset_x(dox), draw_offset_y(doy),
@@ -76,6 +78,7 @@ class sprite final : public gfx {
       if(rate == 0) rate = 1;
       sheet_width = al_get_bitmap_width(_bitmap.get());
       sheet_height = al_get_bitmap_height(_bitmap.get());
+      build_frames(0);
     };
 
     sprite() = delete;    //  Delete default constructor.
@@ -94,6 +97,7 @@ class sprite final : public gfx {
       const std::size_t& stop
     ) {
       auto ret = cycles.insert(std::make_pair(name, std::make_pair(start, stop)));
+      if(ret.second) build_frames(std::max(start, stop));
       return ret.second;
     };
 
@@ -112,6 +116,26 @@ class sprite final : public gfx {
     };
 
   private:
+    //  Position of a frame in the sprite sheet.
+    struct frame_rect {
+      float x, y;
+    };
+
+    //  Add the frame positions up to a frame.
+    void build_frames(const std::size_t& last) {
+      for(std::size_t f = frames.size(); f <= last; f++) {
+        if(sheet_width <= 0) {
+          frames.push_back({ 0.0f, 0.0f });
+          continue;
+        }
+        frames.push_back({
+          (float)((int)(f * sprite_width + sheet_width) % sheet_width),
+          (float)((int)((f * sprite_width) / sheet_width) * sprite_height) });
+      }
+    };
+
+    std::vector<frame_rect> frames;  //  Frame positions, calculated when cycles are added.
+
     //  Animation cycle index.
     std::map<
       const std::string,
@@ -0,0 +1,56 @@
+/*
+ * wtengine
+ * --------
+ * By Matthew Evans
+ * See LICENSE.md for copyright information.
+ */
+
+#if !defined(WTE_CMP_STEERING_HPP)
+#define WTE_CMP_STEERING_HPP
+
+#include "wtengine/_globals/fixed_point.hpp"
+#include "wtengine/cmp/component.hpp"
+
+namespace wte::cmp {
+
+/*!
+ * \class steering
+ * \brief Store flocking information of an entity.  Processed by the Flocking system.
+ *
+ * Entities steer away from close neighbors (separation), match their velocity (alignment)
+ * and move to their center (cohesion).  Only neighbors in the same flock are used.
+ * The entity also needs a location and motion component.
+ */
+class steering final : public component {
+  public:
+    /*!
+     * \brief Create a new Steering component.
+     * \param f Flock the entity belongs to.
+     * \param r Radius to look for neighbors in.
+     * \param s Max speed.
+     * \param m Max change in velocity each tick.
+     */
+    steering(
+      const unsigned int& f,
+      const sim_float& r,
+      const sim_float& s,
+      const sim_float& m
+    ) : flock(f), radius(r), max_speed(s), max_force(m),
+    separation(1), alignment(1), cohesion(1), enabled(true) {};
+
+    steering() = delete;    //  Delete default constructor.
+    ~steering() = default;  //  Default destructor.
+
+    unsigned int flock;    //!<  Flock the entity belongs to.
+    sim_float radius;      //!<  Radius to look for neighbors in.
+    sim_float max_speed;   //!<  Max speed.
+    sim_float max_force;   //!<  Max change in velocity each tick.
+    sim_float separation;  //!<  Weight of steering away from neighbors.
+    sim_float alignment;   //!<  Weight of matching the velocity of neighbors.
+    sim_float cohesion;    //!<  Weight of moving to the center of neighbors.
+    bool enabled;          //!<  Steer or not.
+};
+
+}  //  end namespace wte::cmp
+
+#endif
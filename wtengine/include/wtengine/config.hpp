@@ -90,6 +90,7 @@ class config {
       inline static const bool& audio_installed = _flags::audio_installed;        //!<  Flag to check if audio was installed.
       inline static bool draw_fps = true;                                         //!<  Flag to check if fps should be drawn.
       inline static bool input_enabled = true;                                    //!<  Flag to check if game input is enabled.
+      inline static bool interpolate = false;                                     //!<  Flag to draw sprites between their last and current location.
       inline static const bool& show_hitboxes = _flags::show_hitboxes;            //!<  Flag to enable/disable hitbox rendering.
     };
 
@@ -81,9 +81,12 @@ class display {
       if(h < 1) h = 1;
       config::_gfx::screen_w = w;
       config::_gfx::screen_h = h;
-      al_resize_display(_display, config::gfx::screen_w, config::gfx::screen_h);
-      if(!al_acknowledge_resize(_display))
-        throw engine_error("Failed to resize display!");
+      if constexpr (build_options.headless) return;
+      mgr::gfx::renderer::run_on_render_thread([](){
+        al_resize_display(_display, config::gfx::screen_w, config::gfx::screen_h);
+        if(!al_acknowledge_resize(_display))
+          throw engine_error("Failed to resize display!");
+      });
     };
 
   protected:
@@ -100,6 +103,13 @@ class display {
       if(config::gfx::screen_w == 0) config::_gfx::screen_w = 1920;
       if(config::gfx::screen_h == 0) config::_gfx::screen_h = 1080;
 
+      //  Headless, no display is created and all bitmaps are memory bitmaps.
+      if constexpr (build_options.headless) {
+        _display = NULL;
+        al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+        return;
+      }
+
       al_reset_new_display_options();
 
       //  Configure vsync options.  Gfx driver may override this.
@@ -152,7 +162,7 @@ class display {
 
     //  Destroy the display.
     static void destroy_display(void) {
-      al_destroy_display(_display);
+      if(_display) al_destroy_display(_display);
     };
 
 
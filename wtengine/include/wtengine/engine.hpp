@@ -14,6 +14,7 @@
 #include <vector>
 #include <map>
 #include <functional>
+#include <mutex>
 
 #if defined(__EMSCRIPTEN__)
 #include <emscripten.h>
@@ -77,6 +78,7 @@ class engine final : public config, public input, public display {
       //  Initialize managers that require it.
       mgr::audio::initialize();
       mgr::gfx::renderer::initialize();
+      if constexpr (build_options.render_thread) mgr::gfx::renderer::start_thread();
 
       //  Set default states.
       config::_flags::is_running = true;
@@ -89,6 +91,7 @@ class engine final : public config, public input, public display {
      * Called after the main loop ends running.
      */
     static void wte_unload(void) {
+      if constexpr (build_options.render_thread) mgr::gfx::renderer::stop_thread();
       mgr::audio::de_init();
       mgr::gfx::renderer::de_init();
       mgr::assets::clear_al_objects();
@@ -98,6 +101,13 @@ class engine final : public config, public input, public display {
      * Main engine loop (single pass)
      */
     static void main_loop(void) {
+      //  With a render thread nothing is drawn here, so wait for events instead of spinning.
+      if constexpr (build_options.render_thread)
+        al_wait_for_event_timed(main_event_queue, NULL, 0.001f);
+      //  Keep the render thread out of the world while it is updated.
+      std::unique_lock<std::mutex> world_lock(mgr::gfx::renderer::world_mutex, std::defer_lock);
+      if constexpr (build_options.render_thread) world_lock.lock();
+
       input::check_events();  //  Check for input.
 
       //  Game not running, make sure the timer isn't.
@@ -115,6 +125,7 @@ class engine final : public config, public input, public display {
       }
 
       ALLEGRO_EVENT event;
+      bool ticked = false;
       if(al_get_next_event(main_event_queue, &event)) {
         switch(event.type) {
         //  Call our game logic update on timer events.
@@ -122,12 +133,15 @@ class engine final : public config, public input, public display {
         case ALLEGRO_EVENT_TIMER:
           //  Set the engine_time object to the current time.
           engine_time::set(al_get_timer_count(main_timer));
+          //  Save sprite states for drawing between ticks.
+          mgr::gfx::renderer::save_states();
           //  Run all systems.
           mgr::systems::run();
           //  Process messages.
           mgr::messages::dispatch();
           //  Get any spawner messages and pass to handler.
           mgr::spawner::process_messages(mgr::messages::get("spawner"));
+          ticked = true;
           break;
         //  Check if display looses focus.
         case ALLEGRO_EVENT_DISPLAY_SWITCH_OUT:
@@ -144,13 +158,17 @@ class engine final : public config, public input, public display {
           break;
         //  Window has been resized.
         case ALLEGRO_EVENT_DISPLAY_RESIZE:
-          al_acknowledge_resize(_display);
+          mgr::gfx::renderer::run_on_render_thread([](){ al_acknowledge_resize(_display); });
           break;
         }
       }
 
-      //  Render the screen.
-      mgr::gfx::renderer::render();
+      //  Render the screen, or pass a snapshot to the render thread after each tick.
+      if constexpr (build_options.render_thread) {
+        if(ticked || !config::flags::engine_started) mgr::gfx::renderer::publish();
+      } else {
+        mgr::gfx::renderer::render();
+      }
       //  Get any system messages and pass to handler.
       cmds.process_messages(mgr::messages::get("system"));
       //  Send audio messages to the audio queue.
@@ -193,6 +211,9 @@ class engine final : public config, public input, public display {
       al_stop_timer(main_timer);
       al_set_timer_count(main_timer, 0);
       engine_time::set(al_get_timer_count(main_timer));
+      mgr::spatial::clear();
+      mgr::timers::clear();
+      mgr::gfx::renderer::clear_states();
       config::_flags::engine_started = true;
       config::flags::engine_paused = false;
       al_start_timer(main_timer);
@@ -223,6 +244,8 @@ class engine final : public config, public input, public display {
 
       //  Clear managers.
       mgr::world::clear();
+      mgr::spatial::clear();
+      mgr::timers::clear();
       mgr::systems::clear();
       mgr::messages::clear();
       std::cout << "DONE!\n";
@@ -312,7 +335,7 @@ class engine final : public config, public input, public display {
       std::cout << "OK!\n";
 
       //  Register event sources.
-      al_register_event_source(main_event_queue, al_get_display_event_source(_display));
+      if(_display) al_register_event_source(main_event_queue, al_get_display_event_source(_display));
       al_register_event_source(main_event_queue, al_get_timer_event_source(main_timer));
 
       //  Create the input event queue
@@ -341,6 +364,10 @@ class engine final : public config, public input, public display {
         if(args[0] == "on") config::flags::draw_fps = true;
         if(args[0] == "off") config::flags::draw_fps = false;
       });
+      cmds.add("save-frame-times", 1, [](const msg_args& args) {
+        if(!mgr::gfx::renderer::save_frame_times(args[0]))
+          throw engine_exception("Error saving frame times:  " + args[0], "engine", 2);
+      });
       cmds.add("load-script", 1, [](const msg_args& args) {
         if(config::flags::engine_started && args[0] != "") {
           if(!mgr::messages::load_script(args[0]))
@@ -362,6 +389,15 @@ class engine final : public config, public input, public display {
       cmds.add("scale-factor", 1, [](const msg_args& args) {
         display::set_scale_factor(std::stof(args[0]));
       });
+      if constexpr (build_options.headless) {
+        cmds.add("save-frame", 1, [](const msg_args& args) {
+          const std::string fname = args[0];
+          mgr::gfx::renderer::run_on_render_thread([fname](){
+            if(!mgr::gfx::renderer::save_frame(fname))
+              throw engine_exception("Error saving frame:  " + fname, "engine", 2);
+          });
+        });
+      }
 
       //  Asset commands.
       cmds.add("load-bitmap-asset", 2, [](const msg_args& args) {
@@ -11,9 +11,12 @@
 #include "wtengine/mgr/assets.hpp"
 #include "wtengine/mgr/audio.hpp"
 #include "wtengine/mgr/messages.hpp"
+#include "wtengine/mgr/programs.hpp"
 #include "wtengine/mgr/renderer.hpp"
+#include "wtengine/mgr/spatial.hpp"
 #include "wtengine/mgr/spawner.hpp"
 #include "wtengine/mgr/systems.hpp"
+#include "wtengine/mgr/timers.hpp"
 #include "wtengine/mgr/variables.hpp"
 #include "wtengine/mgr/world.hpp"
 
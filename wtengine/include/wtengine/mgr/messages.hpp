@@ -13,6 +13,9 @@
 #include <iostream>
 #include <sstream>
 #include <vector>
+#include <unordered_map>
+#include <functional>
+#include <utility>
 #include <algorithm>
 #include <stdexcept>
 #include <fstream>
@@ -95,12 +98,69 @@ class messages final : private manager<messages> {
       return true;
     };
 
+    /*!
+     * \brief Call a function once when an entity is sent a command.
+     *
+     * The function is called during dispatch, before the entity's dispatcher.
+     * If the entity is deleted first, the function is dropped without being called,
+     * even if a new entity is given the same name.
+     *
+     * \param to Name of the entity.
+     * \param cmd Command to listen for.
+     * \param func Function to call with the message.
+     */
+    static void listen(
+      const std::string& to,
+      const std::string& cmd,
+      const std::function<void(const message&)>& func
+    ) {
+      listeners.insert(std::make_pair(to, listener{ mgr::world::get_id(to), cmd, func }));
+    };
+
   private:
     messages() = default;
     ~messages() = default;
 
     //  Clear the message queue.
-    static void clear(void) { _messages.clear(); };
+    static void clear(void) {
+      _messages.clear();
+      listeners.clear();
+    };
+
+    //  Function waiting for a command, and the entity it was added for.
+    struct listener {
+      entity_id id;
+      std::string cmd;
+      std::function<void(const message&)> func;
+    };
+
+    //  Call and remove the listeners for a message.
+    static void notify_listeners(const message& msg) {
+      if(listeners.empty()) return;
+      auto range = listeners.equal_range(msg.get_to());
+      if(range.first == range.second) return;
+      //  Remove first, a listener may add new listeners.
+      const entity_id to_id = mgr::world::get_id(msg.get_to());
+      std::vector<std::function<void(const message&)>> funcs;
+      for(auto it = range.first; it != range.second;) {
+        if(it->second.id != to_id) {
+          it = listeners.erase(it);  //  Added for an entity that was deleted.
+        } else if(it->second.cmd == msg.get_cmd()) {
+          funcs.push_back(it->second.func);
+          it = listeners.erase(it);
+        } else it++;
+      }
+      for(auto& func: funcs) func(msg);
+    };
+
+    //  Remove listeners added for entities that were deleted.
+    static void prune_listeners(void) {
+      listeners_version = mgr::world::get_version();
+      for(auto it = listeners.begin(); it != listeners.end();) {
+        if(it->second.id != mgr::world::get_id(it->first)) it = listeners.erase(it);
+        else it++;
+      }
+    };
 
     /*
      * Process dispatcher components. 
@@ -110,23 +170,27 @@ class messages final : private manager<messages> {
     static void dispatch(void) {
       component_container<cmp::dispatcher> dispatch_components =
         mgr::world::set_components<cmp::dispatcher>();
+      if(!listeners.empty() && listeners_version != mgr::world::get_version()) prune_listeners();
 
       while(true) {  //  Infinite loop to verify all current messages are processed.
         message_container temp_msgs = get("entities");
         if(temp_msgs.empty()) break;  //  No messages, end while(true) loop.
 
         //  For all messages, check each dispatch component.
-        for(auto& m_it: temp_msgs) { for(auto& c_it: dispatch_components) {
-          try {
-            if(m_it.get_to() == mgr::world::get_name(c_it.first)) {
-              c_it.second->handle_msg(c_it.first, m_it);
-              break;  //  Found, stop checking dispatch components.
-            }
-          } catch(const std::exception& e) {
-            throw e;
-            break;
-          } catch(...) { break; }
-        }}  //  End double for
+        for(auto& m_it: temp_msgs) {
+          notify_listeners(m_it);
+          for(auto& c_it: dispatch_components) {
+            try {
+              if(m_it.get_to() == mgr::world::get_name(c_it.first)) {
+                c_it.second->handle_msg(c_it.first, m_it);
+                break;  //  Found, stop checking dispatch components.
+              }
+            } catch(const std::exception& e) {
+              throw e;
+              break;
+            } catch(...) { break; }
+          }
+        }  //  End double for
       }
     };
 
@@ -292,6 +356,9 @@ class messages final : private manager<messages> {
     };
 
     inline static message_container _messages;   //  Vector of all messages to be processed
+    //  Functions waiting for a command, by entity name.
+    inline static std::unordered_multimap<std::string, listener> listeners;
+    inline static std::size_t listeners_version = 0;  //  World version listeners were pruned at.
     inline static std::ofstream debug_log_file;  //  For message logging
 };
 
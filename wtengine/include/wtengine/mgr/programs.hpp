@@ -0,0 +1,161 @@
+/*
+ * wtengine
+ * --------
+ * By Matthew Evans
+ * See LICENSE.md for copyright information.
+ */
+
+#if !defined(WTE_MGR_PROGRAMS_HPP)
+#define WTE_MGR_PROGRAMS_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include <allegro5/allegro.h>
+
+#include "wtengine/mgr/manager.hpp"
+
+#include "wtengine/_debug/exceptions.hpp"
+#include "wtengine/_globals/bytecode.hpp"
+
+namespace wte {
+  class engine;
+}
+
+namespace wte::mgr {
+
+/*!
+ * \class programs
+ * \brief Store the compiled behavior programs.
+ *
+ * Programs are loaded by name from files or source.  Reloading a program keeps
+ * its index, so entities running it pick up the new code on their next run.
+ */
+class programs final : private manager<programs> {
+  friend class wte::engine;
+
+  public:
+    /*!
+     * \brief Load a program from a file.
+     *
+     * Files are opened the same way as game data files.
+     *
+     * \param name Name of the program.
+     * \param fname File to load.
+     * \return True if loaded, false if the file was not found.
+     * \exception engine_exception Thrown with the line number if the program does not compile.
+     */
+    static bool load(const std::string& name, const std::string& fname) {
+      std::string src;
+      if(!read_file(fname, src)) return false;
+      if(!load_source(name, src)) return false;
+      sources[index(name)] = fname;
+      return true;
+    };
+
+    /*!
+     * \brief Load a program from source.
+     * \param name Name of the program.
+     * \param src Program source.
+     * \return True if loaded.
+     * \exception engine_exception Thrown with the line number if the program does not compile.
+     */
+    static bool load_source(const std::string& name, const std::string& src) {
+      //  Assemble first, so a program that does not compile keeps its old code.
+      bytecode::program prog = bytecode::assemble(src);
+
+      auto it = names.find(name);
+      if(it == names.end()) {
+        names.insert(std::make_pair(name, _programs.size()));
+        _programs.push_back(std::move(prog));
+        sources.push_back("");
+      } else {
+        _programs[it->second] = std::move(prog);
+      }
+      version++;
+      return true;
+    };
+
+    /*!
+     * \brief Reload all programs loaded from files.
+     *
+     * A program that no longer compiles keeps its old code.
+     * The error is logged when debugging is enabled.
+     *
+     * \return Number of programs reloaded.
+     */
+    static std::size_t reload(void) {
+      std::size_t count = 0;
+      for(auto& it: names) {
+        const std::string fname = sources[it.second];
+        std::string src;
+        if(fname.empty() || !read_file(fname, src)) continue;
+        try {
+          if(load_source(it.first, src)) count++;
+        } catch(const engine_exception&) { continue; }
+      }
+      return count;
+    };
+
+    /*!
+     * \brief Check if a program is loaded.
+     * \param name Name of the program.
+     * \return True if loaded, false if not.
+     */
+    static bool exists(const std::string& name) {
+      return (names.find(name) != names.end());
+    };
+
+    /*!
+     * \brief Get the index of a program.
+     * \param name Name of the program.
+     * \return Index of the program.
+     * \exception engine_exception Thrown if the program is not loaded.
+     */
+    static std::size_t index(const std::string& name) {
+      auto it = names.find(name);
+      if(it == names.end())
+        throw engine_exception("Program " + name + " does not exist", "Programs", 2);
+      return it->second;
+    };
+
+    /*!
+     * \brief Get a program by index.
+     * \param idx Index of the program.
+     * \return The compiled program.
+     */
+    static const bytecode::program& get(const std::size_t& idx) { return _programs[idx]; };
+
+    /*!
+     * \brief Get the programs version.  Changed when a program is loaded.
+     * \return Programs version.
+     */
+    static std::size_t get_version(void) { return version; };
+
+  private:
+    programs() = default;
+    ~programs() = default;
+
+    //  Read a whole file.
+    static bool read_file(const std::string& fname, std::string& src) {
+      ALLEGRO_FILE* file = al_fopen(fname.c_str(), "rb");
+      if(!file) return false;
+      char buffer[1024];
+      std::size_t read = 0;
+      while((read = al_fread(file, buffer, sizeof(buffer))) > 0) src.append(buffer, read);
+      al_fclose(file);
+      return true;
+    };
+
+    inline static std::vector<bytecode::program> _programs;  //  Compiled programs.
+    inline static std::vector<std::string> sources;          //  File each program was loaded from.
+    inline static std::map<std::string, std::size_t> names;  //  Program index by name.
+    inline static std::size_t version = 0;
+};
+
+template <> bool manager<programs>::initialized = false;
+
+}  //  end namespace wte::mgr
+
+#endif
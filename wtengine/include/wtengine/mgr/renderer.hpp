@@ -9,30 +9,44 @@
 #define WTE_MGR_RENDERER_HPP
 
 #include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
 #include <utility>
 #include <set>
 #include <iterator>
 #include <functional>
+#include <type_traits>
 #include <memory>
 #include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
 #include <stdexcept>
 #include <cassert>
+#include <cstdio>
 
 #include <allegro5/allegro.h>
 #include <allegro5/allegro_image.h>
 #include <allegro5/allegro_font.h>
+#include <allegro5/allegro_primitives.h>
 
 #include "wtengine/mgr/manager.hpp"
 
+#include "wtengine/_debug/debug_draw.hpp"
+#include "wtengine/_debug/frame_timing.hpp"
 #include "wtengine/_debug/exceptions.hpp"
 #include "wtengine/_globals/_defines.hpp"
 #include "wtengine/_globals/engine_time.hpp"
+#include "wtengine/_globals/triple_buffer.hpp"
 #include "wtengine/_globals/wte_asset.hpp"
 #include "wtengine/cmp/_components.hpp"
 #include "wtengine/mgr/assets.hpp"
 #include "wtengine/mgr/world.hpp"
 #include "wtengine/config.hpp"
-#include "wtengine/display.hpp"
 
 namespace wte {
   class display;
@@ -42,7 +56,12 @@ namespace wte {
   using time_point = std::chrono::time_point<T>;
 
   using system_clock = std::chrono::system_clock;
-  using duration = std::chrono::system_clock::duration;
+  using steady_clock = std::chrono::steady_clock;
+  using duration = std::chrono::steady_clock::duration;
+}
+
+namespace wte::sys::gfx {
+  class animate;
 }
 
 namespace wte::mgr::gfx {
@@ -57,10 +76,33 @@ using entity_component_pair = std::pair<const entity_id, std::shared_ptr<const T
 /*!
  * \class renderer
  * \brief An object that handles drawing the world to the screen.
+ *
+ * Within a layer, drawing is grouped by bitmap and held, so Allegro can batch
+ * the draws that share a bitmap.  Draws on the same layer are grouped by bitmap,
+ * with the groups in order of the first entity using each bitmap, then ordered by entity.
+ *
+ * Drawables that are not rotated, scaled or tinted skip the transform.  Such sprites
+ * are collected into a vertex batch drawn with one primitives call per bitmap.
+ *
+ * The world is first copied into a snapshot of what to draw, then the snapshot is drawn.
+ * When built with WTE_RENDER_THREAD, the engine publishes a snapshot at the end of each
+ * tick and a render thread that owns the display draws each new one, so the next tick
+ * runs while the frame is drawn.  The render thread sleeps until a snapshot is published
+ * or a job is queued, so frames are not drawn twice.  In that mode:
+ *  - Background and overlay animations run on the render thread while the world is locked.
+ *    Sprite animations run with the systems and must not draw.
+ *  - Bitmaps created on the game thread after the engine starts are memory bitmaps.
+ *    Those made with make_asset are converted to video bitmaps by the render thread
+ *    before its next frame.  Others can be created with run_on_render_thread.
+ *  - Sprites are not interpolated.
+ *
+ * When built with WTE_HEADLESS there is no display.  Frames are drawn to a memory bitmap
+ * the size of the screen, which can be saved or hashed to check the output.
  */
 class renderer final : private manager<renderer> {
   friend class wte::display;
   friend class wte::engine;
+  friend class wte::sys::gfx::animate;
 
   private:
     renderer() = default;
@@ -73,6 +115,8 @@ class renderer final : private manager<renderer> {
       if(config::gfx::viewport_w == 0 || config::gfx::viewport_h == 0) throw std::runtime_error("Arena size not defined!");
       //  Create the arena bitmap.
       viewport_bitmap = make_asset<ALLEGRO_BITMAP>(config::gfx::viewport_w, config::gfx::viewport_h);
+      if constexpr (build_options.headless)
+        frame_bitmap = make_asset<ALLEGRO_BITMAP>(config::gfx::screen_w, config::gfx::screen_h);
       arena_created = true;
 
       //  Set the overlay's font to the system default.
@@ -87,266 +131,506 @@ class renderer final : private manager<renderer> {
         title_bitmap = make_asset<ALLEGRO_BITMAP>(title_screen_file);
       }
 
-      fps_timer = al_create_timer(1);
-      fps_event_queue = al_create_event_queue();
-      al_register_event_source(fps_event_queue, al_get_timer_event_source(fps_timer));
-      al_start_timer(fps_timer);
-
-      _start_time = _last_render = system_clock::now();
-      _delta_time = system_clock::now() - system_clock::now();
+      _start_time = _last_render = steady_clock::now();
+      _delta_time = duration::zero();
+      share_stats();
     };
     
     //  Destories the internal objects.
     static void de_init(void) {
       viewport_bitmap.reset();
+      frame_bitmap.reset();
       title_bitmap.reset();
       renderer_font.reset();
-      al_destroy_event_queue(fps_event_queue);
-      al_destroy_timer(fps_timer);
     };
     
-    //  Draw hitboxes if debug mode is enabled.
+    //  Sprite state at the start of a tick.  Used for interpolation.
+    struct sprite_state {
+      entity_id id;
+      float pos_x, pos_y;
+      float direction;
+      float scale_factor_x, scale_factor_y;
+    };
+
+    /*
+     * Save the sprite states before the systems run.
+     * Called by the engine at the start of each tick.
+     */
+    static void save_states(void) {
+      last_tick = steady_clock::now();
+      if(!config::flags::interpolate) return;
+
+      previous_states.clear();
+      const const_component_container<cmp::gfx::sprite> sprite_components =
+        mgr::world::get_components<cmp::gfx::sprite>();
+      for(auto& it: sprite_components) {
+        cmp::const_comp_ptr<cmp::location> temp_get = mgr::world::get_component<cmp::location>(it.first);
+        previous_states.push_back({ it.first, temp_get->pos_x, temp_get->pos_y,
+          it.second->direction, it.second->scale_factor_x, it.second->scale_factor_y });
+      }
+    };
+
+    //  Clear the saved sprite states.
+    static void clear_states(void) {
+      previous_states.clear();
+    };
+
+    //  Get how far the render is between the last tick and the next, from 0 to 1.
+    static float tick_alpha(void) {
+      if(config::flags::engine_paused) return 1.0f;
+      const float elapsed = std::chrono::duration<float>(steady_clock::now() - last_tick).count();
+      return std::clamp(elapsed * build_options.ticks_per_sec, 0.0f, 1.0f);
+    };
+
+    //  Find the saved state of a sprite.  States are in entity order.
+    static const sprite_state* find_state(const entity_id& e_id) {
+      auto it = std::lower_bound(previous_states.begin(), previous_states.end(), e_id,
+        [](const sprite_state& a, const entity_id& b){ return a.id < b; });
+      if(it == previous_states.end() || it->id != e_id) return nullptr;
+      return &(*it);
+    };
+
+    //  Interpolate an angle the short way around.
+    static float lerp_angle(const float& a, const float& b, const float& t) {
+      float diff = std::fmod(b - a, 2.0f * (float)M_PI);
+      if(diff > (float)M_PI) diff -= 2.0f * (float)M_PI;
+      if(diff < -(float)M_PI) diff += 2.0f * (float)M_PI;
+      return a + diff * t;
+    };
+
+    //  Queue the hitboxes to the debug draw if debug mode is enabled.
     static void draw_hitboxes(void) {
       const const_component_container<cmp::hitbox> hitbox_components =
         mgr::world::get_components<cmp::hitbox>();
+      const const_component_container<cmp::location> location_components =
+        mgr::world::get_components<cmp::location>();
 
+      //  Both are in entity order, so walk them together.
+      auto loc = location_components.begin();
       for(auto& it: hitbox_components) {
-        if(it.second->solid) {
-          //  Select color based on team.
-          ALLEGRO_COLOR team_color;
-          switch(it.second->team) {
-            case 0: team_color = al_map_rgb(0,255,0); break;
-            case 1: team_color = al_map_rgb(255,0,0); break;
-            case 2: team_color = al_map_rgb(0,0,255); break;
-            default: team_color = al_map_rgb(255,255,0);
-          }
-          //  Draw the hitbox.
-          ALLEGRO_BITMAP* temp_bitmap = al_create_bitmap(
-            it.second->width,
-            it.second->height);
-          al_set_target_bitmap(temp_bitmap);
-          al_clear_to_color(team_color);
-          al_set_target_bitmap(viewport_bitmap.get());
-          try {
-            al_draw_bitmap(temp_bitmap,
-              mgr::world::get_component<cmp::location>(it.first)->pos_x,
-              mgr::world::get_component<cmp::location>(it.first)->pos_y, 0);
-          } catch(const std::exception& e) { throw e; }
-          al_destroy_bitmap(temp_bitmap);
+        while(loc != location_components.end() && loc->first < it.first) loc++;
+        if(loc == location_components.end()) break;
+        if(loc->first != it.first || !it.second->solid) continue;
+
+        //  Select color based on team.
+        ALLEGRO_COLOR team_color;
+        switch(it.second->team) {
+          case 0: team_color = al_map_rgb(0,255,0); break;
+          case 1: team_color = al_map_rgb(255,0,0); break;
+          case 2: team_color = al_map_rgb(0,0,255); break;
+          default: team_color = al_map_rgb(255,255,0);
         }
+        debug_draw::rect(loc->second->pos_x, loc->second->pos_y,
+          it.second->width, it.second->height, team_color, true);
       }
     };
-    
-    //  Draw time if debug mode is enabled.
-    static void draw_timer(void) {
+
+    //  One bitmap draw in a snapshot.
+    struct draw_item {
+      ALLEGRO_BITMAP* bitmap;
+      float sx, sy, sw, sh;    //  Region of the bitmap.
+      float cx, cy;            //  Center to rotate around.
+      float dx, dy;            //  Destination.
+      float scale_x, scale_y;
+      float angle;
+      ALLEGRO_COLOR tint;
+      bool transformed;        //  False to draw the region as is.
+    };
+
+    //  Everything needed to draw a frame, copied from the world.
+    struct frame_snapshot {
+      bool started;                             //  Draw the world, or the title screen.
+      int64_t timer;                            //  Engine time of the snapshot.
+      std::vector<draw_item> items;             //  Draws in order.
+      std::size_t sprites_begin;                //  First sprite in the items.
+      std::size_t overlays_begin;               //  First overlay in the items.
+      std::vector<wte_asset<ALLEGRO_BITMAP>> bitmaps;  //  Keeps the bitmaps alive until drawn.
+      std::vector<ALLEGRO_VERTEX> debug_vertices;      //  Debug draw shapes.
+      std::vector<debug_draw::text_item> debug_texts;  //  Debug draw text.
+      std::size_t draw_calls, batches, culled;
+    };
+
+    //  Draw time and draw counts if debug mode is enabled.
+    static void draw_timer(const frame_snapshot& s) {
       if constexpr (build_options.debug_mode) {
-        const std::string timer_string = "Timer: " + std::to_string(engine_time::check());
+        const std::string timer_string = "Timer: " + std::to_string(s.timer);
         al_draw_text(renderer_font.get(), al_map_rgb(255,255,0), config::gfx::screen_w, 10, ALLEGRO_ALIGN_RIGHT, timer_string.c_str());
+        const std::string draw_string = "Drawn: " + std::to_string(s.draw_calls) +
+          "  Culled: " + std::to_string(s.culled) + "  Batches: " + std::to_string(s.batches);
+        al_draw_text(renderer_font.get(), al_map_rgb(255,255,0), config::gfx::screen_w, 20, ALLEGRO_ALIGN_RIGHT, draw_string.c_str());
       }
     };
 
-    //  For sorting.
-    template <typename T> struct comparator {
-      bool operator() (const T& a, const T& b) const {
-        return *a.second < *b.second;
+    /*
+     * Components of one type to draw, kept sorted by layer, then bitmap, then entity.
+     * Draws using the same bitmap are next to each other, so they can be batched.
+     * Bitmaps are ordered by the first entity using them, not their address, so the
+     * draw order is the same on each run.
+     * Rebuilt when components are added or deleted, and sorted again only when
+     * a layer or bitmap changes.  Layers are bucket sorted.
+     */
+    template <typename T>
+    struct render_list {
+      struct entry {
+        entity_id id;
+        std::shared_ptr<const T> comp;
+        cmp::const_comp_ptr<cmp::location> loc;  //  Only found for sprites.
+        std::size_t layer;
+        ALLEGRO_BITMAP* bitmap;
+        entity_id group;  //  First entity in the layer using the bitmap.
+      };
+
+      render_list() : version(0), valid(false) {};
+
+      //  Bring the list up to date with the world.
+      void update(void) {
+        if(!valid || version != mgr::world::get_version()) {
+          const const_component_container<T> components = mgr::world::get_components<T>();
+          entries.clear();
+          for(auto& it: components) {
+            cmp::const_comp_ptr<cmp::location> loc = nullptr;
+            if constexpr (std::is_same_v<T, cmp::gfx::sprite>)
+              loc = mgr::world::get_component<cmp::location>(it.first);
+            entries.push_back({ it.first, it.second, loc, it.second->layer, it.second->_bitmap.get(), 0 });
+          }
+          version = mgr::world::get_version();
+          valid = true;
+          sort();
+          return;
+        }
+
+        bool changed = false;
+        for(auto& it: entries) {
+          if(it.layer != it.comp->layer || it.bitmap != it.comp->_bitmap.get()) {
+            it.layer = it.comp->layer;
+            it.bitmap = it.comp->_bitmap.get();
+            changed = true;
+          }
+        }
+        if(changed) sort();
+      };
+
+      //  Sort by layer, then bitmap, then entity.
+      void sort(void) {
+        std::size_t max_layer = 0;
+        for(auto& it: entries) max_layer = std::max(max_layer, it.layer);
+        if(max_layer >= MAX_BUCKETS) {
+          std::sort(entries.begin(), entries.end(), [](const entry& a, const entry& b) {
+            if(a.layer != b.layer) return a.layer < b.layer;
+            return a.id < b.id;
+          });
+          auto first = entries.begin();
+          while(first != entries.end()) {
+            const std::size_t layer = first->layer;
+            const auto last = std::find_if(first, entries.end(), [&layer](const entry& e) { return e.layer != layer; });
+            sort_layer(first, last);
+            first = last;
+          }
+          return;
+        }
+
+        //  Bucket by layer, then sort each layer.
+        bucket_start.assign(max_layer + 2, 0);
+        for(auto& it: entries) bucket_start[it.layer + 1]++;
+        for(std::size_t i = 1; i < bucket_start.size(); i++) bucket_start[i] += bucket_start[i - 1];
+        sorted.resize(entries.size());
+        bucket_fill.assign(bucket_start.begin(), bucket_start.end() - 1);
+        for(auto& it: entries) sorted[bucket_fill[it.layer]++] = std::move(it);
+        entries.swap(sorted);
+        for(std::size_t l = 0; l <= max_layer; l++)
+          sort_layer(entries.begin() + bucket_start[l], entries.begin() + bucket_start[l + 1]);
+      };
+
+      //  Group the entries of one layer by bitmap, the groups in order of their first entity.
+      void sort_layer(
+        const typename std::vector<entry>::iterator& first,
+        const typename std::vector<entry>::iterator& last
+      ) {
+        first_user.clear();
+        for(auto it = first; it != last; it++) {
+          const auto res = first_user.try_emplace(it->bitmap, it->id);
+          if(!res.second && it->id < res.first->second) res.first->second = it->id;
+        }
+        for(auto it = first; it != last; it++) it->group = first_user[it->bitmap];
+        std::sort(first, last, [](const entry& a, const entry& b) {
+          if(a.group != b.group) return a.group < b.group;
+          return a.id < b.id;
+        });
+      };
+
+      void clear(void) {
+        entries.clear();
+        sorted.clear();
+        first_user.clear();
+        valid = false;
+      };
+
+      std::vector<entry> entries;
+      std::vector<entry> sorted;
+      std::vector<std::size_t> bucket_start, bucket_fill;
+      std::unordered_map<ALLEGRO_BITMAP*, entity_id> first_user;  //  First entity using each bitmap in a layer.
+      std::size_t version;
+      bool valid;
+    };
+
+    inline static const std::size_t MAX_BUCKETS = 1024;  //  Layers above this are sorted instead.
+
+    /*
+     * Check if a drawable's bounds overlap the viewport.
+     * Unrotated drawables are drawn from their top left, rotated ones around their center.
+     */
+    static bool in_viewport(
+      const float& x, const float& y,
+      const float& w, const float& h,
+      const float& sx, const float& sy,
+      const bool& rotated, const float& angle
+    ) {
+      float min_x, min_y, max_x, max_y;
+      if(rotated) {
+        const float hw = std::abs(w * sx) / 2.0f, hh = std::abs(h * sy) / 2.0f;
+        const float c = std::abs(std::cos(angle)), s = std::abs(std::sin(angle));
+        const float ex = c * hw + s * hh, ey = s * hw + c * hh;
+        min_x = x - ex; max_x = x + ex;
+        min_y = y - ey; max_y = y + ey;
+      } else {
+        min_x = std::min(x, x + w * sx); max_x = std::max(x, x + w * sx);
+        min_y = std::min(y, y + h * sy); max_y = std::max(y, y + h * sy);
       }
+      return (max_x >= 0.0f && min_x <= (float)config::gfx::viewport_w &&
+              max_y >= 0.0f && min_y <= (float)config::gfx::viewport_h);
     };
 
-    //  Draw the game screen.
-    static void render(void) {
-      /*
-      * Calculate fps.
-      */
-      fps_counter++;
-      //  Update fps on unique ticks only.
-      const bool queue_not_empty = al_get_next_event(fps_event_queue, &fps_event);
-      if(queue_not_empty && fps_event.type == ALLEGRO_EVENT_TIMER) {
-        _fps = fps_counter;
-        fps_counter = 0;
-        al_set_timer_count(fps_timer, 0);
+    //  Add a sprite frame to the quad batch.  Draws the batch first if the bitmap changed.
+    static void add_quad(
+      ALLEGRO_BITMAP* bmp,
+      const float& sx, const float& sy,
+      const float& w, const float& h,
+      const float& dx, const float& dy
+    ) {
+      if(bmp != quad_bitmap) flush_quads();
+      quad_bitmap = bmp;
+      const ALLEGRO_COLOR white = al_map_rgba_f(1.0f, 1.0f, 1.0f, 1.0f);
+      const ALLEGRO_VERTEX tl = { dx, dy, 0.0f, sx, sy, white };
+      const ALLEGRO_VERTEX tr = { dx + w, dy, 0.0f, sx + w, sy, white };
+      const ALLEGRO_VERTEX bl = { dx, dy + h, 0.0f, sx, sy + h, white };
+      const ALLEGRO_VERTEX br = { dx + w, dy + h, 0.0f, sx + w, sy + h, white };
+      quad_vertices.insert(quad_vertices.end(), { tl, tr, bl, tr, br, bl });
+    };
+
+    /*
+     * Draw the quad batch with one primitives call.
+     * Held bitmap drawing is flushed first, so the draw order is kept.
+     */
+    static void flush_quads(void) {
+      if(quad_vertices.empty()) return;
+      const bool held = al_is_bitmap_drawing_held();
+      if(held) al_hold_bitmap_drawing(false);
+      al_draw_prim(quad_vertices.data(), NULL, quad_bitmap, 0, (int)quad_vertices.size(), ALLEGRO_PRIM_TRIANGLE_LIST);
+      if(held) al_hold_bitmap_drawing(true);
+      quad_vertices.clear();
+    };
+
+    //  Count a draw, and a new batch when the bitmap changes.
+    static void count_draw(ALLEGRO_BITMAP* bmp) {
+      _draw_calls++;
+      if(bmp != last_bitmap) {
+        _batches++;
+        last_bitmap = bmp;
+      }
+    };
+
+    //  Add a draw to a snapshot.  Keeps a reference to each bitmap drawn.
+    static void add_item(frame_snapshot& s, const wte_asset<ALLEGRO_BITMAP>& bmp, const draw_item& item) {
+      if(item.bitmap != last_bitmap) s.bitmaps.push_back(bmp);
+      count_draw(item.bitmap);
+      s.items.push_back(item);
+    };
+
+    //  Add a background or overlay to a snapshot.
+    template <typename T>
+    static void add_bitmap(frame_snapshot& s, const T& c) {
+      ALLEGRO_BITMAP* bmp = c._bitmap.get();
+      const float w = al_get_bitmap_width(bmp), h = al_get_bitmap_height(bmp);
+      float angle = 0.0f;
+      float center_x = 0.0f, center_y = 0.0f;
+      float destination_x = 0.0f, destination_y = 0.0f;
+
+      if(c.rotated) {
+        angle = c.direction;
+        center_x = (w / 2);
+        center_y = (h / 2);
+        destination_x = c.pos_x + (w * c.scale_factor_x / 2);
+        destination_y = c.pos_y + (h * c.scale_factor_y / 2);
+      } else {
+        destination_x = c.pos_x;
+        destination_y = c.pos_y;
+      }
+
+      if(!in_viewport(destination_x, destination_y, w, h,
+           c.scale_factor_x, c.scale_factor_y, c.rotated, angle)) {
+        _culled++;
+        return;
       }
+      add_item(s, c._bitmap, { bmp, 0.0f, 0.0f, w, h, center_x, center_y,
+        destination_x, destination_y, c.scale_factor_x, c.scale_factor_y, angle,
+        (c.tinted ? c.get_tint() : al_map_rgba_f(1.0f, 1.0f, 1.0f, 1.0f)),
+        (c.rotated || c.tinted || c.scale_factor_x != 1.0f || c.scale_factor_y != 1.0f) });
+    };
 
+    //  Copy what to draw from the world into a snapshot.
+    static void build_snapshot(frame_snapshot& s) {
+      s.started = config::flags::engine_started;
+      s.timer = engine_time::check();
+      s.items.clear();
+      s.bitmaps.clear();
+      s.sprites_begin = s.overlays_begin = 0;
+      _draw_calls = _batches = _culled = 0;
+      last_bitmap = nullptr;
+
+      if(!s.started) {
+        debug_draw::clear();
+        s.debug_vertices.clear();
+        s.debug_texts.clear();
+        s.draw_calls = s.batches = s.culled = 0;
+        return;
+      }
+
+      //  Add each background by layer.
+      background_list.update();
+      for(auto& it: background_list.entries)
+        if(it.comp->visible) add_bitmap(s, *it.comp);
+
+      //  Add the sprites.
+      s.sprites_begin = s.items.size();
+      sprite_list.update();
+
+      //  Blend from the last tick's state if interpolating.
+      const float alpha = (config::flags::interpolate && !build_options.render_thread ? tick_alpha() : 1.0f);
+
+      for(auto& it: sprite_list.entries) {
+        if(it.comp->visible) {
+          float angle = 0.0f;
+          float center_x = 0.0f, center_y = 0.0f;
+          float destination_x = 0.0f, destination_y = 0.0f;
+          float pos_x = it.loc->pos_x, pos_y = it.loc->pos_y;
+          float direction = it.comp->direction;
+          float scale_x = it.comp->scale_factor_x, scale_y = it.comp->scale_factor_y;
+          if(alpha < 1.0f) {
+            const sprite_state* prev = find_state(it.id);
+            if(prev) {
+              pos_x = prev->pos_x + (pos_x - prev->pos_x) * alpha;
+              pos_y = prev->pos_y + (pos_y - prev->pos_y) * alpha;
+              direction = lerp_angle(prev->direction, direction, alpha);
+              scale_x = prev->scale_factor_x + (scale_x - prev->scale_factor_x) * alpha;
+              scale_y = prev->scale_factor_y + (scale_y - prev->scale_factor_y) * alpha;
+            }
+          }
+
+          //  Check if the sprite should be rotated.
+          if(it.comp->rotated) {
+            angle = direction;
+            center_x = (it.comp->sprite_width / 2);
+            center_y = (it.comp->sprite_height / 2);
+
+            destination_x = pos_x +
+              (it.comp->sprite_width * scale_x / 2) +
+              (it.comp->draw_offset_x * scale_x);
+            destination_y = pos_y +
+              (it.comp->sprite_height * scale_y / 2) +
+              (it.comp->draw_offset_y * scale_y);
+          } else {
+            destination_x = pos_x + it.comp->draw_offset_x;
+            destination_y = pos_y + it.comp->draw_offset_y;
+          }
+
+          if(!in_viewport(destination_x, destination_y,
+               it.comp->sprite_width, it.comp->sprite_height,
+               scale_x, scale_y, it.comp->rotated, angle)) {
+            _culled++;
+            continue;
+          }
+
+          //  The current frame from the sprite sheet.
+          add_item(s, it.comp->_bitmap, { it.comp->_bitmap.get(),
+            it.comp->sprite_x, it.comp->sprite_y, it.comp->sprite_width, it.comp->sprite_height,
+            center_x, center_y, destination_x, destination_y, scale_x, scale_y, angle,
+            (it.comp->tinted ? it.comp->get_tint() : al_map_rgba_f(1.0f, 1.0f, 1.0f, 1.0f)),
+            (it.comp->rotated || it.comp->tinted || scale_x != 1.0f || scale_y != 1.0f) });
+        }
+      }
+
+      //  Hitboxes if debug is enabled, and anything else queued to the debug draw.
+      if constexpr (build_options.debug_mode)
+        if(config::flags::show_hitboxes) draw_hitboxes();
+      debug_draw::take(s.debug_vertices, s.debug_texts);
+
+      //  Add each overlay by layer.
+      s.overlays_begin = s.items.size();
+      overlay_list.update();
+      for(auto& it: overlay_list.entries)
+        if(it.comp->visible) add_bitmap(s, *it.comp);
+
+      s.draw_calls = _draw_calls;
+      s.batches = _batches;
+      s.culled = _culled;
+    };
+
+    /*
+     * Draw a range of snapshot items.
+     * Untransformed items are added to the quad batch if batching, or drawn as is.
+     */
+    static void draw_items(const frame_snapshot& s, const std::size_t& begin, const std::size_t& end, const bool& batch) {
+      for(std::size_t i = begin; i < end; i++) {
+        const draw_item& it = s.items[i];
+        if(!it.transformed) {
+          if(batch) add_quad(it.bitmap, it.sx, it.sy, it.sw, it.sh, it.dx, it.dy);
+          else al_draw_bitmap(it.bitmap, it.dx, it.dy, 0);
+          continue;
+        }
+        flush_quads();
+        al_draw_tinted_scaled_rotated_bitmap_region(
+          it.bitmap, it.sx, it.sy, it.sw, it.sh, it.tint,
+          it.cx, it.cy, it.dx, it.dy, it.scale_x, it.scale_y, it.angle, 0
+        );
+      }
+    };
+
+    //  Draw a snapshot to the screen.
+    static void draw_snapshot(const frame_snapshot& s) {
       //  Toggle no preserve texture for faster rendering.
-      al_set_new_bitmap_flags(ALLEGRO_NO_PRESERVE_TEXTURE);
+      al_set_new_bitmap_flags(build_options.headless ? ALLEGRO_MEMORY_BITMAP : ALLEGRO_NO_PRESERVE_TEXTURE);
 
       //  Set drawing to the screen.
-      al_set_target_backbuffer(al_get_current_display());
+      target_screen();
       al_clear_to_color(al_map_rgb(0,0,0));
 
       //  Render world if the game is running.
-      if(config::flags::engine_started) {
+      if(s.started) {
         //  Set drawing to the arena bitmap.
         al_set_target_bitmap(viewport_bitmap.get());
         al_clear_to_color(al_map_rgb(0,0,0));
 
         //  Draw the backgrounds.
-        const const_component_container<cmp::gfx::background> background_components =
-          mgr::world::get_components<cmp::gfx::background>();
-
-        //  Sort the background layers.
-        std::multiset<entity_component_pair<cmp::gfx::background>,
-          comparator<entity_component_pair<cmp::gfx::background>>> background_componenet_set(
-          background_components.begin(), background_components.end());
-
-        //  Draw each background by layer.
-        for(auto& it: background_componenet_set) {
-          if(it.second->visible) {
-            float angle = 0.0f;
-            float center_x = 0.0f, center_y = 0.0f;
-            float destination_x = 0.0f, destination_y = 0.0f;
-
-            if(it.second->rotated) {
-              angle = it.second->direction;
-              center_x = (al_get_bitmap_width(it.second->_bitmap.get()) / 2);
-              center_y = (al_get_bitmap_height(it.second->_bitmap.get()) / 2);
-
-              destination_x = it.second->pos_x +
-                (al_get_bitmap_width(it.second->_bitmap.get()) * it.second->scale_factor_x / 2);
-              destination_y = it.second->pos_y +
-                (al_get_bitmap_height(it.second->_bitmap.get()) * it.second->scale_factor_y / 2);
-            } else {
-              destination_x = it.second->pos_x;
-              destination_y = it.second->pos_y;
-            }
-
-            if(it.second->tinted)
-              al_draw_tinted_scaled_rotated_bitmap(
-                it.second->_bitmap.get(), it.second->get_tint(),
-                center_x, center_y, destination_x, destination_y,
-                it.second->scale_factor_x,
-                it.second->scale_factor_y,
-                angle, 0
-              );
-            else
-              al_draw_scaled_rotated_bitmap(
-                it.second->_bitmap.get(),
-                center_x, center_y, destination_x, destination_y,
-                it.second->scale_factor_x,
-                it.second->scale_factor_y,
-                angle, 0
-              );
-          }
-        }
+        al_hold_bitmap_drawing(true);
+        draw_items(s, 0, s.sprites_begin, false);
+        al_hold_bitmap_drawing(false);
 
         //  Draw the sprites.
-        const const_component_container<cmp::gfx::sprite> sprite_components =
-          mgr::world::get_components<cmp::gfx::sprite>();
-
-        //  Sort the sprite components.
-        std::multiset<entity_component_pair<cmp::gfx::sprite>,
-          comparator<entity_component_pair<cmp::gfx::sprite>>> sprite_componenet_set(
-          sprite_components.begin(), sprite_components.end());
-
-        //  Draw each sprite in order.
-        for(auto& it: sprite_componenet_set) {
-          if(it.second->visible) {
-            //  Get the current sprite frame.
-            ALLEGRO_BITMAP* temp_bitmap = al_create_sub_bitmap(
-              it.second->_bitmap.get(),
-              it.second->sprite_x,
-              it.second->sprite_y,
-              it.second->sprite_width,
-              it.second->sprite_height
-            );
-
-            float angle = 0.0f;
-            float center_x = 0.0f, center_y = 0.0f;
-            float destination_x = 0.0f, destination_y = 0.0f;
-            cmp::const_comp_ptr<cmp::location> temp_get = mgr::world::get_component<cmp::location>(it.first);
-
-            //  Check if the sprite should be rotated.
-            if(it.second->rotated) {
-              angle = it.second->direction;
-              center_x = (al_get_bitmap_width(temp_bitmap) / 2);
-              center_y = (al_get_bitmap_height(temp_bitmap) / 2);
-
-              destination_x = temp_get->pos_x +
-                (al_get_bitmap_width(temp_bitmap) * it.second->scale_factor_x / 2) +
-                (it.second->draw_offset_x * it.second->scale_factor_x);
-              destination_y = temp_get->pos_y +
-                (al_get_bitmap_height(temp_bitmap) * it.second->scale_factor_y / 2) +
-                (it.second->draw_offset_y * it.second->scale_factor_y);
-            } else {
-              destination_x = temp_get->pos_x + it.second->draw_offset_x;
-              destination_y = temp_get->pos_y + it.second->draw_offset_y;
-            }
-
-            //  Draw the sprite.
-            if(it.second->tinted)
-              al_draw_tinted_scaled_rotated_bitmap(
-                  temp_bitmap, it.second->get_tint(),
-                  center_x, center_y, destination_x, destination_y,
-                  it.second->scale_factor_x,
-                  it.second->scale_factor_y,
-                  angle, 0
-              );
-            else
-              al_draw_scaled_rotated_bitmap(
-                  temp_bitmap, center_x, center_y, destination_x, destination_y,
-                  it.second->scale_factor_x,
-                  it.second->scale_factor_y,
-                  angle, 0
-              );
-
-            al_destroy_bitmap(temp_bitmap);
-          }
-        }
+        al_hold_bitmap_drawing(true);
+        draw_items(s, s.sprites_begin, s.overlays_begin, true);
+        flush_quads();
+        al_hold_bitmap_drawing(false);
 
-        //  Draw hitboxes if debug is enabled.
-        if constexpr (build_options.debug_mode)
-          if(config::flags::show_hitboxes) draw_hitboxes();
+        //  Draw the debug shapes and text.
+        debug_draw::draw(s.debug_vertices, s.debug_texts, renderer_font.get());
 
         //  Draw the overlays.
-        const const_component_container<cmp::gfx::overlay> overlay_components =
-          mgr::world::get_components<cmp::gfx::overlay>();
-
-        //  Sort the overlay layers.
-        std::multiset<entity_component_pair<cmp::gfx::overlay>,
-          comparator<entity_component_pair<cmp::gfx::overlay>>> overlay_componenet_set(
-          overlay_components.begin(), overlay_components.end());
-
-        //  Draw each overlay by layer.
-        for(auto& it: overlay_componenet_set) {
-          if(it.second->visible) {
-            float angle = 0.0f;
-            float center_x = 0.0f, center_y = 0.0f;
-            float destination_x = 0.0f, destination_y = 0.0f;
-
-            if(it.second->rotated) {
-              angle = it.second->direction;
-              center_x = (al_get_bitmap_width(it.second->_bitmap.get()) / 2);
-              center_y = (al_get_bitmap_height(it.second->_bitmap.get()) / 2);
-
-              destination_x = it.second->pos_x +
-                (al_get_bitmap_width(it.second->_bitmap.get()) * it.second->scale_factor_x / 2);
-              destination_y = it.second->pos_y +
-                (al_get_bitmap_height(it.second->_bitmap.get()) * it.second->scale_factor_y / 2);
-            } else {
-              destination_x = it.second->pos_x;
-              destination_y = it.second->pos_y;
-            }
-
-            if(it.second->tinted)
-              al_draw_tinted_scaled_rotated_bitmap(
-                it.second->_bitmap.get(), it.second->get_tint(),
-                center_x, center_y, destination_x, destination_y,
-                it.second->scale_factor_x,
-                it.second->scale_factor_y,
-                angle, 0
-              );
-            else
-              al_draw_scaled_rotated_bitmap(
-                it.second->_bitmap.get(),
-                center_x, center_y, destination_x, destination_y,
-                it.second->scale_factor_x,
-                it.second->scale_factor_y,
-                angle, 0
-              );
-          }
-        }
+        al_hold_bitmap_drawing(true);
+        draw_items(s, s.overlays_begin, s.items.size(), false);
+        al_hold_bitmap_drawing(false);
 
         //  Draw the viewport bitmap to the screen.
-        al_set_target_backbuffer(al_get_current_display());
+        target_screen();
         al_draw_scaled_bitmap(
           viewport_bitmap.get(), 0, 0, config::gfx::viewport_w, config::gfx::viewport_h,
           (config::gfx::screen_w / 2) - (config::gfx::viewport_w * config::gfx::scale_factor / 2),
@@ -363,33 +647,220 @@ class renderer final : private manager<renderer> {
           al_get_bitmap_height(title_bitmap.get()) * config::gfx::scale_factor, 0);
       }
 
-      //  Draw frame rate.
+      //  Draw frame rate and frame times.
       if(config::flags::draw_fps) {
-        const std::string fps_string = "FPS: " + std::to_string(fps);
-        al_draw_text(renderer_font.get(), al_map_rgb(255,255,0), config::gfx::screen_w, 1, ALLEGRO_ALIGN_RIGHT, fps_string.c_str());
+        char fps_string[128];
+        {
+          std::lock_guard<std::mutex> lock(stats_mutex);
+          std::snprintf(fps_string, sizeof fps_string,
+            "FPS: %zu  p50: %.1f  p95: %.1f  p99: %.1f  max: %.1f ms  Over: %zu",
+            _fps, _frame_times.percentile(50.0f), _frame_times.percentile(95.0f),
+            _frame_times.percentile(99.0f), _frame_times.max(), _frame_times.over_budget());
+        }
+        al_draw_text(renderer_font.get(), al_map_rgb(255,255,0), config::gfx::screen_w, 1, ALLEGRO_ALIGN_RIGHT, fps_string);
       }
-      if constexpr (build_options.debug_mode) draw_timer();
+      if constexpr (build_options.debug_mode) draw_timer(s);
       
-      //  Update the screen & delta time.
-      al_flip_display();
-      _delta_time = system_clock::now() - _last_render;
-      _last_render = system_clock::now();
-    }
+      //  Update the screen, delta time & frame times.
+      if constexpr (!build_options.headless) al_flip_display();
+      const time_point<steady_clock> now = steady_clock::now();
+      std::lock_guard<std::mutex> lock(stats_mutex);
+      _delta_time = now - _last_render;
+      _last_render = now;
+      _frame_times.add(std::chrono::duration<float, std::milli>(_delta_time).count());
+      _fps = static_cast<std::size_t>(std::round(_frame_times.fps()));
+    };
+
+    //  Copy the frame stats written by the drawing side for the game thread.
+    static void share_stats(void) {
+      std::lock_guard<std::mutex> lock(stats_mutex);
+      shared_fps = _fps;
+      shared_last_render = _last_render;
+      shared_delta_time = _delta_time;
+      shared_frame_times = _frame_times;
+    };
+
+    //  Set drawing to the display, or to the frame bitmap when headless.
+    static void target_screen(void) {
+      if constexpr (build_options.headless) {
+        //  Follow the screen size if the display was resized.
+        if(al_get_bitmap_width(frame_bitmap.get()) != config::gfx::screen_w ||
+           al_get_bitmap_height(frame_bitmap.get()) != config::gfx::screen_h)
+          frame_bitmap = make_asset<ALLEGRO_BITMAP>(config::gfx::screen_w, config::gfx::screen_h);
+        al_set_target_bitmap(frame_bitmap.get());
+      } else {
+        al_set_target_backbuffer(al_get_current_display());
+      }
+    };
+
+    //  Copy the world into a snapshot and pass it to the drawing side.
+    static void publish(void) {
+      if constexpr (build_options.render_thread) {
+        rethrow_job_error();
+        share_stats();
+      }
+      build_snapshot(snapshots.write_buffer());
+      snapshots.publish();
+      if constexpr (build_options.render_thread) wake_render_thread();
+    };
+
+    //  Draw the game screen.
+    static void render(void) {
+      publish();
+      snapshots.acquire();
+      draw_snapshot(snapshots.read_buffer());
+      share_stats();
+    };
+
+    //  Run a background or overlay animation if it needs to.
+    static void run_animation(cmp::gfx::gfx& g, const entity_id& e_id) {
+      if(g.visible && g.needs_update()) g.animate(e_id);
+    };
+
+    //  Count a tick of background and overlay animations for the render thread.
+    static void defer_animations(void) { pending_animations++; };
+
+    //  Run the animations counted since the last frame, with the world locked.
+    static void run_animations(void) {
+      const std::size_t count = pending_animations.exchange(0);
+      if(count == 0) return;
+      std::lock_guard<std::mutex> lock(world_mutex);
+      for(std::size_t i = 0; i < count; i++) {
+        for(auto& it: mgr::world::set_components<cmp::gfx::background>()) run_animation(*it.second, it.first);
+        for(auto& it: mgr::world::set_components<cmp::gfx::overlay>()) run_animation(*it.second, it.first);
+      }
+    };
+
+    //  Run the functions waiting for the render thread.
+    static void run_jobs(void) {
+      std::vector<std::function<void(void)>> jobs;
+      {
+        std::lock_guard<std::mutex> lock(jobs_mutex);
+        jobs.swap(render_jobs);
+        jobs_waiting = false;
+      }
+      for(auto& it: jobs) {
+        //  Keep the error for the game thread, an exception leaving the render thread ends the program.
+        try {
+          it();
+        } catch(...) {
+          std::lock_guard<std::mutex> lock(jobs_mutex);
+          if(!job_error) job_error = std::current_exception();
+        }
+      }
+    };
+
+    //  Throw the first error from a render thread job on the game thread.
+    static void rethrow_job_error(void) {
+      std::exception_ptr error;
+      {
+        std::lock_guard<std::mutex> lock(jobs_mutex);
+        error.swap(job_error);
+      }
+      if(error) std::rethrow_exception(error);
+    };
+
+    //  Convert memory bitmaps made on the game thread since the last check, with the world locked.
+    static void convert_bitmaps(void) {
+      if(bitmaps_created == bitmaps_converted) return;
+      std::lock_guard<std::mutex> lock(world_mutex);
+      bitmaps_converted = bitmaps_created;
+      al_convert_memory_bitmaps();
+    };
+
+    //  Wake the render thread if it is waiting.  Call after making the change it waits for.
+    static void wake_render_thread(void) {
+      //  Taking the lock makes sure the render thread is either waiting or will see the change.
+      { std::lock_guard<std::mutex> lock(signal_mutex); }
+      render_signal.notify_one();
+    };
+
+    //  Draw each new snapshot until stopped.  Owns the display while running.
+    static void render_loop(void) {
+      if(render_display) al_set_target_backbuffer(render_display);
+      while(thread_running) {
+        run_jobs();
+        if constexpr (!build_options.headless) convert_bitmaps();
+        run_animations();
+        if(snapshots.acquire()) {
+          draw_snapshot(snapshots.read_buffer());
+        } else {
+          //  Nothing new to draw, wait for a tick, a job or a stop.
+          std::unique_lock<std::mutex> lock(signal_mutex);
+          render_signal.wait(lock, [](){
+            return !thread_running || jobs_waiting || pending_animations > 0 || snapshots.has_new();
+          });
+        }
+      }
+      run_jobs();
+      al_set_target_bitmap(NULL);
+    };
 
-    inline static ALLEGRO_TIMER* fps_timer = NULL;
-    inline static ALLEGRO_EVENT_QUEUE* fps_event_queue = NULL;
-    inline static ALLEGRO_EVENT fps_event;
+    //  Hand the display to a new render thread.
+    static void start_thread(void) {
+      render_display = al_get_current_display();
+      al_set_target_bitmap(NULL);
+      //  Without the display, new bitmaps are memory bitmaps kept for convert_bitmaps.
+      if constexpr (!build_options.headless) al_set_new_bitmap_flags(ALLEGRO_CONVERT_BITMAP);
+      bitmaps_converted = bitmaps_created;
+      thread_running = true;
+      draw_thread = std::thread(render_loop);
+    };
+
+    //  Stop the render thread and take the display back.
+    static void stop_thread(void) {
+      thread_running = false;
+      wake_render_thread();
+      if(draw_thread.joinable()) draw_thread.join();
+      if(render_display) al_set_target_backbuffer(render_display);
+    };
 
     inline static wte_asset<ALLEGRO_BITMAP> viewport_bitmap = nullptr;
     inline static wte_asset<ALLEGRO_BITMAP> title_bitmap = nullptr;
+    inline static wte_asset<ALLEGRO_BITMAP> frame_bitmap = nullptr;  //  Screen when headless.
     inline static wte_asset<ALLEGRO_FONT> renderer_font = nullptr;
 
-    inline static std::size_t fps_counter = 0, _fps = 0;
-    inline static time_point<system_clock> _last_render, _start_time;
+    //  Frame stats, written by the drawing side.  Guarded by stats_mutex.
+    inline static std::size_t _fps = 0;
+    inline static time_point<steady_clock> _last_render, _start_time;
     inline static duration _delta_time;
+    inline static frame_timing _frame_times;  //  Times of the last frames.
+    inline static std::mutex stats_mutex;
+
+    //  Copies of the frame stats read by the game thread.  Updated each tick.
+    inline static std::size_t shared_fps = 0;
+    inline static time_point<steady_clock> shared_last_render;
+    inline static duration shared_delta_time;
+    inline static frame_timing shared_frame_times;
 
     inline static bool arena_created = false;
 
+    inline static render_list<cmp::gfx::background> background_list;  //  Backgrounds to draw.
+    inline static render_list<cmp::gfx::sprite> sprite_list;          //  Sprites to draw.
+    inline static render_list<cmp::gfx::overlay> overlay_list;        //  Overlays to draw.
+    inline static std::size_t _draw_calls = 0, _batches = 0, _culled = 0;
+    inline static ALLEGRO_BITMAP* last_bitmap = nullptr;  //  Bitmap of the last draw.
+    inline static std::vector<ALLEGRO_VERTEX> quad_vertices;  //  Sprite frames waiting to be drawn.
+    inline static ALLEGRO_BITMAP* quad_bitmap = nullptr;      //  Bitmap of the quad batch.
+
+    inline static triple_buffer<frame_snapshot> snapshots;  //  Snapshots passed to the drawing side.
+
+    inline static std::thread draw_thread;                           //  Render thread.
+    inline static std::atomic<bool> thread_running = false;          //  Keep the render thread running.
+    inline static ALLEGRO_DISPLAY* render_display = NULL;            //  Display owned by the render thread.
+    inline static std::mutex world_mutex;                            //  Held while the world is used.
+    inline static std::atomic<std::size_t> pending_animations = 0;   //  Animation ticks for the render thread.
+    inline static std::mutex jobs_mutex;                             //  Guards render_jobs.
+    inline static std::vector<std::function<void(void)>> render_jobs;  //  Functions for the render thread.
+    inline static std::atomic<bool> jobs_waiting = false;            //  Set while render_jobs has functions.
+    inline static std::size_t bitmaps_converted = 0;                 //  Value of bitmaps_created at the last convert.
+    inline static std::exception_ptr job_error = nullptr;            //  First error from a job.  Guarded by jobs_mutex.
+    inline static std::mutex signal_mutex;                           //  Used to wait for work.
+    inline static std::condition_variable render_signal;             //  Wakes the render thread.
+
+    inline static time_point<steady_clock> last_tick;         //  Time of the last tick.
+    inline static std::vector<sprite_state> previous_states;  //  Sprite states at the start of the last tick.
+
     inline static std::string title_screen_file;
     inline static std::string background_file;
 
@@ -399,6 +870,28 @@ class renderer final : private manager<renderer> {
      */
     inline static std::function<void(void)> draw_gui =  ([](){});
 
+    /*!
+     * \brief Run a function on the thread that owns the display.
+     *
+     * With a render thread, the function is run before the next frame is drawn,
+     * and an exception it throws is rethrown on the game thread at the next publish.
+     * Otherwise it is run now.  Use this to create or draw to video bitmaps.
+     *
+     * \param func Function to run.
+     */
+    static void run_on_render_thread(const std::function<void(void)>& func) {
+      if constexpr (build_options.render_thread) {
+        {
+          std::lock_guard<std::mutex> lock(jobs_mutex);
+          render_jobs.push_back(func);
+          jobs_waiting = true;
+        }
+        wake_render_thread();
+      } else {
+        func();
+      }
+    };
+
     /*!
      * \brief Set the viewport size.
      * 
@@ -439,10 +932,80 @@ class renderer final : private manager<renderer> {
      */
     static void set_font(wte_asset<ALLEGRO_FONT> font) { renderer_font = font; };
 
-    inline static const std::size_t& fps = _fps;                               //!<  Frames per second
-    inline static const time_point<system_clock>& last_render = _last_render;  //!<  Point in time last render completed
-    inline static const time_point<system_clock>& start_time = _start_time;    //!<  Point in time the renderer started
-    inline static const duration& delta_time = _delta_time;                    //!<  Time between frame renders
+    /*!
+     * \brief Set the frame time budget.
+     *
+     * Frames taking longer are counted as over budget.  Defaults to one tick.
+     *
+     * \param ms Budget in milliseconds.
+     */
+    static void set_frame_budget(const float& ms) {
+      std::lock_guard<std::mutex> lock(stats_mutex);
+      _frame_times.set_budget(ms);
+    };
+
+    /*!
+     * \brief Append a summary of the frame times to a CSV file.
+     *
+     * See frame_timing::save_csv for the columns.
+     * Uses the frame times as of the last tick.
+     *
+     * \param fname File to write to.
+     * \return False on fail, true on success.
+     */
+    static bool save_frame_times(const std::string& fname) { return shared_frame_times.save_csv(fname); };
+
+    /*!
+     * \brief Save the last frame drawn.  Headless builds only.
+     *
+     * The file type is set by the extension, see the Allegro docs on al_save_bitmap.
+     * With a render thread, call this with run_on_render_thread.
+     *
+     * \param fname Filename to save to.
+     * \return False on fail, true on success.
+     */
+    static bool save_frame(const std::string& fname) {
+      if(!build_options.headless || !frame_bitmap) return false;
+      return al_save_bitmap(fname.c_str(), frame_bitmap.get());
+    };
+
+    /*!
+     * \brief Hash the pixels of the last frame drawn.  Headless builds only.
+     *
+     * Uses 64 bit FNV-1a over the pixels in RGBA order, so equal frames give equal hashes.
+     * With a render thread, call this with run_on_render_thread.
+     *
+     * \return Hash of the frame, zero if there is no frame.
+     */
+    static uint64_t frame_hash(void) {
+      if(!build_options.headless || !frame_bitmap) return 0;
+      ALLEGRO_BITMAP* bmp = frame_bitmap.get();
+      ALLEGRO_LOCKED_REGION* region =
+        al_lock_bitmap(bmp, ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE, ALLEGRO_LOCK_READONLY);
+      if(!region) return 0;
+
+      uint64_t hash = 14695981039346656037ULL;
+      const int row_size = al_get_bitmap_width(bmp) * 4;
+      for(int y = 0; y < al_get_bitmap_height(bmp); y++) {
+        //  Rows can be padded, so step by the pitch.
+        const unsigned char* row = static_cast<const unsigned char*>(region->data) + y * region->pitch;
+        for(int x = 0; x < row_size; x++) {
+          hash ^= row[x];
+          hash *= 1099511628211ULL;
+        }
+      }
+      al_unlock_bitmap(bmp);
+      return hash;
+    };
+
+    inline static const std::size_t& fps = shared_fps;                               //!<  Frames per second over the frame times
+    inline static const time_point<steady_clock>& last_render = shared_last_render;  //!<  Point in time last render completed
+    inline static const time_point<steady_clock>& start_time = _start_time;          //!<  Point in time the renderer started
+    inline static const duration& delta_time = shared_delta_time;                    //!<  Time between frame renders
+    inline static const frame_timing& frame_times = shared_frame_times;              //!<  Times of the last frames
+    inline static const std::size_t& draw_calls = _draw_calls;                 //!<  Bitmaps drawn in the last frame
+    inline static const std::size_t& batches = _batches;                       //!<  Bitmap changes in the last frame
+    inline static const std::size_t& culled = _culled;                         //!<  Drawables outside the viewport in the last frame
 
 };
 
@@ -0,0 +1,520 @@
+/*
+ * wtengine
+ * --------
+ * By Matthew Evans
+ * See LICENSE.md for copyright information.
+ */
+
+#if !defined(WTE_MGR_SPATIAL_HPP)
+#define WTE_MGR_SPATIAL_HPP
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+
+#include "wtengine/mgr/manager.hpp"
+
+#include "wtengine/_globals/engine_time.hpp"
+#include "wtengine/cmp/hitbox.hpp"
+#include "wtengine/cmp/location.hpp"
+#include "wtengine/mgr/world.hpp"
+
+namespace wte {
+  class engine;
+}
+
+namespace wte::mgr {
+
+/*!
+ * \class spatial
+ * \brief Grid index of entity locations for proximity queries.
+ *
+ * Indexes every entity with a location component.  If the entity has a hitbox,
+ * its width and height are used as its bounds, otherwise it is a point.
+ * The index is rebuilt by the first query of each tick and reflects the
+ * locations at that time.  If the entities are spread too far for the grid,
+ * the cells are made larger.
+ *
+ * Queries write to a vector passed by the caller.  Reuse it between queries
+ * so it does not allocate once it has grown large enough.
+ */
+class spatial final : private manager<spatial> {
+  friend class wte::engine;
+
+  public:
+    /*!
+     * \brief Set the size of the grid cells.
+     *
+     * Use a size close to the size of the typical entity or query.
+     * This is the smallest size used, cells grow if the grid would be too large.
+     *
+     * \param s Cell size in pixels.
+     */
+    static void set_cell_size(const float& s) {
+      if(s > 0.0f) cell_size = s;
+      invalidate();
+    };
+
+    /*!
+     * \brief Force the index to be rebuilt by the next query.
+     *
+     * Use if entities were moved and need to be queried again in the same tick.
+     */
+    static void invalidate(void) { built = false; };
+
+    /*!
+     * \brief Find entities with bounds overlapping a rectangle.
+     * \param x Left of the rectangle.
+     * \param y Top of the rectangle.
+     * \param w Width of the rectangle.
+     * \param h Height of the rectangle.
+     * \param results Vector to store found entities.  Cleared first.
+     * \return Number of entities found.
+     */
+    static std::size_t query_rect(
+      const float& x,
+      const float& y,
+      const float& w,
+      const float& h,
+      std::vector<entity_id>& results
+    ) {
+      refresh();
+      results.clear();
+      if(items.empty()) return 0;
+      next_stamp();
+
+      int min_cx, min_cy, max_cx, max_cy;
+      cell_range(x, y, x + w, y + h, min_cx, min_cy, max_cx, max_cy);
+      for(int cy = min_cy; cy <= max_cy; cy++) {
+        for(int cx = min_cx; cx <= max_cx; cx++) {
+          const std::size_t cell = cy * grid_w + cx;
+          for(std::size_t i = cell_start[cell]; i < cell_start[cell + 1]; i++) {
+            item& it = items[cell_items[i]];
+            if(it.stamp == stamp) continue;
+            it.stamp = stamp;
+            if(it.x <= x + w && it.x + it.w >= x && it.y <= y + h && it.y + it.h >= y)
+              results.push_back(it.id);
+          }
+        }
+      }
+      return results.size();
+    };
+
+    /*!
+     * \brief Find entities with bounds within a distance of a point.
+     * \param x X position of the point.
+     * \param y Y position of the point.
+     * \param r Distance from the point.
+     * \param results Vector to store found entities.  Cleared first.
+     * \return Number of entities found.
+     */
+    static std::size_t query_radius(
+      const float& x,
+      const float& y,
+      const float& r,
+      std::vector<entity_id>& results
+    ) {
+      refresh();
+      results.clear();
+      if(items.empty()) return 0;
+      next_stamp();
+
+      int min_cx, min_cy, max_cx, max_cy;
+      cell_range(x - r, y - r, x + r, y + r, min_cx, min_cy, max_cx, max_cy);
+      for(int cy = min_cy; cy <= max_cy; cy++) {
+        for(int cx = min_cx; cx <= max_cx; cx++) {
+          const std::size_t cell = cy * grid_w + cx;
+          for(std::size_t i = cell_start[cell]; i < cell_start[cell + 1]; i++) {
+            item& it = items[cell_items[i]];
+            if(it.stamp == stamp) continue;
+            it.stamp = stamp;
+            if(distance_sq(it, x, y) <= r * r) results.push_back(it.id);
+          }
+        }
+      }
+      return results.size();
+    };
+
+    /*!
+     * \brief Find the first entity hit by a ray.
+     * \param x X position of the ray start.
+     * \param y Y position of the ray start.
+     * \param dx X direction of the ray.
+     * \param dy Y direction of the ray.
+     * \param max_dist Maximum length of the ray.
+     * \param hit_id Set to the entity hit.
+     * \param hit_dist Set to the distance of the hit.
+     * \param ignore Entity to ignore, such as the one casting the ray.
+     * \return True if an entity was hit, false if not.
+     */
+    static bool raycast(
+      const float& x,
+      const float& y,
+      const float& dx,
+      const float& dy,
+      const float& max_dist,
+      entity_id& hit_id,
+      float& hit_dist,
+      const entity_id& ignore = world::ENTITY_ERROR
+    ) {
+      refresh();
+      if(items.empty()) return false;
+      const float len = std::sqrt(dx * dx + dy * dy);
+      if(len == 0.0f) return false;
+      const float dir_x = dx / len, dir_y = dy / len;
+
+      //  Clip the ray to the grid.  Every entity is inside it.
+      float travelled = 0.0f, clip_end = max_dist;
+      if(!clip_axis(x, dir_x, origin_x, origin_x + grid_w * cell_w, travelled, clip_end)) return false;
+      if(!clip_axis(y, dir_y, origin_y, origin_y + grid_h * cell_h, travelled, clip_end)) return false;
+      next_stamp();
+
+      //  Walk the cells along the ray, starting where it enters the grid.
+      int cx = cell_x(x + dir_x * travelled), cy = cell_y(y + dir_y * travelled);
+      const int step_x = (dir_x > 0.0f ? 1 : -1), step_y = (dir_y > 0.0f ? 1 : -1);
+      const float inf = std::numeric_limits<float>::infinity();
+      const float delta_x = (dir_x != 0.0f ? std::abs(cell_w / dir_x) : inf);
+      const float delta_y = (dir_y != 0.0f ? std::abs(cell_h / dir_y) : inf);
+      float next_x = (dir_x != 0.0f ?
+        ((origin_x + (cx + (step_x > 0 ? 1 : 0)) * cell_w) - x) / dir_x : inf);
+      float next_y = (dir_y != 0.0f ?
+        ((origin_y + (cy + (step_y > 0 ? 1 : 0)) * cell_h) - y) / dir_y : inf);
+
+      bool found = false;
+      float best = max_dist;
+      while(travelled <= best) {
+        const std::size_t cell = cy * grid_w + cx;
+        for(std::size_t i = cell_start[cell]; i < cell_start[cell + 1]; i++) {
+          item& it = items[cell_items[i]];
+          if(it.stamp == stamp || it.id == ignore) continue;
+          it.stamp = stamp;
+          float t;
+          if(ray_hit(it, x, y, dir_x, dir_y, t) && t <= best) {
+            best = t;
+            hit_id = it.id;
+            found = true;
+          }
+        }
+        //  Step to the next cell, stopping at the edge of the grid.
+        if(next_x < next_y) {
+          travelled = next_x;
+          next_x += delta_x;
+          cx += step_x;
+        } else {
+          travelled = next_y;
+          next_y += delta_y;
+          cy += step_y;
+        }
+        if(cx < 0 || cy < 0 || cx >= grid_w || cy >= grid_h) break;
+      }
+      if(found) hit_dist = best;
+      return found;
+    };
+
+    /*!
+     * \brief Find the nearest entities to a point.
+     * \param x X position of the point.
+     * \param y Y position of the point.
+     * \param k Number of entities to find.
+     * \param results Vector to store found entities, nearest first.  Cleared first.
+     * \param ignore Entity to ignore, such as the one searching.
+     * \return Number of entities found.
+     */
+    static std::size_t nearest(
+      const float& x,
+      const float& y,
+      const std::size_t& k,
+      std::vector<entity_id>& results,
+      const entity_id& ignore = world::ENTITY_ERROR
+    ) {
+      refresh();
+      results.clear();
+      nearest_dist.clear();
+      if(items.empty() || k == 0) return 0;
+      next_stamp();
+
+      //  Search rings of cells around the point until no closer entity can be found.
+      const int px = cell_x(x), py = cell_y(y);
+      const int max_ring = std::max(grid_w, grid_h);
+      for(int ring = 0; ring <= max_ring; ring++) {
+        if(ring > 0 && results.size() == k &&
+           unvisited_distance_sq(x, y, px, py, ring - 1) > nearest_dist.back()) break;
+        for(int cy = py - ring; cy <= py + ring; cy++) {
+          if(cy < 0 || cy >= grid_h) continue;
+          //  Only visit the edge of the ring.
+          const int cx_step = (cy == py - ring || cy == py + ring ? 1 : std::max(ring * 2, 1));
+          for(int cx = px - ring; cx <= px + ring; cx += cx_step) {
+            if(cx < 0 || cx >= grid_w) continue;
+            const std::size_t cell = cy * grid_w + cx;
+            for(std::size_t i = cell_start[cell]; i < cell_start[cell + 1]; i++) {
+              item& it = items[cell_items[i]];
+              if(it.stamp == stamp || it.id == ignore) continue;
+              it.stamp = stamp;
+              insert_nearest(it.id, distance_sq(it, x, y), k, results);
+            }
+          }
+        }
+      }
+      return results.size();
+    };
+
+  private:
+    spatial() = default;
+    ~spatial() = default;
+
+    //  Indexed entity and its bounds.
+    struct item {
+      entity_id id;
+      float x, y, w, h;
+      uint32_t stamp;
+    };
+
+    //  Components of an indexed entity.  Kept until the world structure changes.
+    struct tracked {
+      entity_id id;
+      cmp::const_comp_ptr<cmp::location> location;
+      cmp::const_comp_ptr<cmp::hitbox> hitbox;
+    };
+
+    //  Clear the index.
+    static void clear(void) {
+      items.clear();
+      tracked_items.clear();
+      built = false;
+    };
+
+    //  Rebuild the index if it was not built this tick.
+    static void refresh(void) {
+      if(built && built_at == engine_time::check()) return;
+      built = true;
+      built_at = engine_time::check();
+
+      //  Only look up the components again if the world structure changed.
+      if(tracked_version != mgr::world::get_version() || tracked_items.empty()) {
+        tracked_version = mgr::world::get_version();
+        tracked_items.clear();
+        const const_component_container<cmp::location> location_components =
+          mgr::world::get_components<cmp::location>();
+        const const_component_container<cmp::hitbox> hitbox_components =
+          mgr::world::get_components<cmp::hitbox>();
+        for(auto& it: location_components) {
+          auto hb = hitbox_components.find(it.first);
+          tracked_items.push_back({ it.first, it.second,
+            (hb != hitbox_components.end() ? hb->second : nullptr) });
+        }
+      }
+
+      items.clear();
+      for(auto& it: tracked_items) {
+        if(it.hitbox)
+          items.push_back({ it.id, it.location->pos_x, it.location->pos_y,
+                            it.hitbox->width, it.hitbox->height, 0 });
+        else
+          items.push_back({ it.id, it.location->pos_x, it.location->pos_y, 0.0f, 0.0f, 0 });
+      }
+      stamp = 0;
+      if(items.empty()) return;
+
+      //  Size the grid to fit all entities.
+      float min_x = items[0].x, min_y = items[0].y;
+      float max_x = items[0].x + items[0].w, max_y = items[0].y + items[0].h;
+      for(auto& it: items) {
+        min_x = std::min(min_x, it.x);
+        min_y = std::min(min_y, it.y);
+        max_x = std::max(max_x, it.x + it.w);
+        max_y = std::max(max_y, it.y + it.h);
+      }
+      origin_x = min_x;
+      origin_y = min_y;
+      //  Grow the cells if there would be too many, so every entity is inside the grid.
+      cell_w = std::max(cell_size, (max_x - min_x) / (MAX_CELLS - 1));
+      cell_h = std::max(cell_size, (max_y - min_y) / (MAX_CELLS - 1));
+      grid_w = std::clamp((int)((max_x - min_x) / cell_w) + 1, 1, MAX_CELLS);
+      grid_h = std::clamp((int)((max_y - min_y) / cell_h) + 1, 1, MAX_CELLS);
+
+      //  Count the entities in each cell, then fill the cells.
+      cell_start.assign(grid_w * grid_h + 1, 0);
+      for(auto& it: items) {
+        int min_cx, min_cy, max_cx, max_cy;
+        cell_range(it.x, it.y, it.x + it.w, it.y + it.h, min_cx, min_cy, max_cx, max_cy);
+        for(int cy = min_cy; cy <= max_cy; cy++)
+          for(int cx = min_cx; cx <= max_cx; cx++) cell_start[cy * grid_w + cx + 1]++;
+      }
+      for(std::size_t i = 1; i < cell_start.size(); i++) cell_start[i] += cell_start[i - 1];
+      cell_items.resize(cell_start.back());
+      cell_fill.assign(cell_start.begin(), cell_start.end() - 1);
+      for(std::size_t i = 0; i < items.size(); i++) {
+        int min_cx, min_cy, max_cx, max_cy;
+        cell_range(items[i].x, items[i].y, items[i].x + items[i].w, items[i].y + items[i].h,
+                   min_cx, min_cy, max_cx, max_cy);
+        for(int cy = min_cy; cy <= max_cy; cy++)
+          for(int cx = min_cx; cx <= max_cx; cx++)
+            cell_items[cell_fill[cy * grid_w + cx]++] = i;
+      }
+    };
+
+    //  Start a new query.  Items marked with the current stamp were already checked.
+    static void next_stamp(void) {
+      stamp++;
+      if(stamp == 0) {
+        for(auto& it: items) it.stamp = 0;
+        stamp = 1;
+      }
+    };
+
+    //  Get the cell column for a position, limited to the grid.
+    static int cell_x(const float& x) {
+      return std::clamp((int)std::floor((x - origin_x) / cell_w), 0, grid_w - 1);
+    };
+
+    //  Get the cell row for a position, limited to the grid.
+    static int cell_y(const float& y) {
+      return std::clamp((int)std::floor((y - origin_y) / cell_h), 0, grid_h - 1);
+    };
+
+    //  Get the range of cells covering a rectangle.
+    static void cell_range(
+      const float& x1, const float& y1,
+      const float& x2, const float& y2,
+      int& min_cx, int& min_cy, int& max_cx, int& max_cy
+    ) {
+      min_cx = cell_x(x1);
+      min_cy = cell_y(y1);
+      max_cx = cell_x(x2);
+      max_cy = cell_y(y2);
+    };
+
+    //  Squared distance from a point to the bounds of an item.
+    static float distance_sq(const item& it, const float& x, const float& y) {
+      const float dx = x - std::clamp(x, it.x, it.x + it.w);
+      const float dy = y - std::clamp(y, it.y, it.y + it.h);
+      return dx * dx + dy * dy;
+    };
+
+    //  Squared distance from a point to a rectangle of cells.
+    static float cells_distance_sq(
+      const float& x, const float& y,
+      const int& min_cx, const int& min_cy, const int& max_cx, const int& max_cy
+    ) {
+      const float dx = x - std::clamp(x, origin_x + min_cx * cell_w, origin_x + (max_cx + 1) * cell_w);
+      const float dy = y - std::clamp(y, origin_y + min_cy * cell_h, origin_y + (max_cy + 1) * cell_h);
+      return dx * dx + dy * dy;
+    };
+
+    /*
+     * Squared distance from a point to the closest cell not yet searched,
+     * after searching the rings up to the given ring around a cell.
+     * Infinite if every cell was searched.
+     */
+    static float unvisited_distance_sq(
+      const float& x, const float& y,
+      const int& px, const int& py, const int& ring
+    ) {
+      const int min_cx = std::max(px - ring, 0), max_cx = std::min(px + ring, grid_w - 1);
+      const int min_cy = std::max(py - ring, 0), max_cy = std::min(py + ring, grid_h - 1);
+      float dist = std::numeric_limits<float>::infinity();
+      //  Columns left and right of the searched cells, then rows above and below.
+      if(min_cx > 0) dist = std::min(dist, cells_distance_sq(x, y, 0, 0, min_cx - 1, grid_h - 1));
+      if(max_cx < grid_w - 1)
+        dist = std::min(dist, cells_distance_sq(x, y, max_cx + 1, 0, grid_w - 1, grid_h - 1));
+      if(min_cy > 0) dist = std::min(dist, cells_distance_sq(x, y, min_cx, 0, max_cx, min_cy - 1));
+      if(max_cy < grid_h - 1)
+        dist = std::min(dist, cells_distance_sq(x, y, min_cx, max_cy + 1, max_cx, grid_h - 1));
+      return dist;
+    };
+
+    //  Clip a ray to the grid on one axis.  False if it misses.
+    static bool clip_axis(
+      const float& pos, const float& dir,
+      const float& min, const float& max,
+      float& t_enter, float& t_exit
+    ) {
+      if(dir == 0.0f) return (pos >= min && pos <= max);
+      float t1 = (min - pos) / dir, t2 = (max - pos) / dir;
+      if(t1 > t2) std::swap(t1, t2);
+      t_enter = std::max(t_enter, t1);
+      t_exit = std::min(t_exit, t2);
+      return (t_enter <= t_exit);
+    };
+
+    //  Ray to bounds test.  Sets the distance to the hit.
+    static bool ray_hit(
+      const item& it,
+      const float& x, const float& y,
+      const float& dir_x, const float& dir_y,
+      float& t
+    ) {
+      float t_min = 0.0f;
+      float t_max = std::numeric_limits<float>::infinity();
+      if(dir_x == 0.0f) {
+        if(x < it.x || x > it.x + it.w) return false;
+      } else {
+        float t1 = (it.x - x) / dir_x, t2 = (it.x + it.w - x) / dir_x;
+        if(t1 > t2) std::swap(t1, t2);
+        t_min = std::max(t_min, t1);
+        t_max = std::min(t_max, t2);
+      }
+      if(dir_y == 0.0f) {
+        if(y < it.y || y > it.y + it.h) return false;
+      } else {
+        float t1 = (it.y - y) / dir_y, t2 = (it.y + it.h - y) / dir_y;
+        if(t1 > t2) std::swap(t1, t2);
+        t_min = std::max(t_min, t1);
+        t_max = std::min(t_max, t2);
+      }
+      if(t_min > t_max) return false;
+      t = t_min;
+      return true;
+    };
+
+    //  Keep the k nearest results sorted by distance.
+    static void insert_nearest(
+      const entity_id& id,
+      const float& dist,
+      const std::size_t& k,
+      std::vector<entity_id>& results
+    ) {
+      if(results.size() == k && dist >= nearest_dist.back()) return;
+      if(results.size() < k) {
+        results.push_back(id);
+        nearest_dist.push_back(dist);
+      } else {
+        results.back() = id;
+        nearest_dist.back() = dist;
+      }
+      for(std::size_t i = results.size() - 1; i > 0 && nearest_dist[i] < nearest_dist[i - 1]; i--) {
+        std::swap(results[i], results[i - 1]);
+        std::swap(nearest_dist[i], nearest_dist[i - 1]);
+      }
+    };
+
+    inline static const int MAX_CELLS = 256;  //  Max cells per grid row or column.
+
+    inline static float cell_size = 64.0f;  //  Smallest size of each cell.
+    inline static float cell_w = 64.0f;     //  Size of each cell in the current grid.
+    inline static float cell_h = 64.0f;
+    inline static float origin_x = 0.0f;    //  Position of the top left cell.
+    inline static float origin_y = 0.0f;
+    inline static int grid_w = 1;           //  Grid size in cells.
+    inline static int grid_h = 1;
+
+    inline static std::vector<item> items;               //  Indexed entities.
+    inline static std::vector<tracked> tracked_items;    //  Components of the indexed entities.
+    inline static std::size_t tracked_version = 0;       //  World version of tracked_items.
+    inline static std::vector<std::size_t> cell_start;   //  Start of each cell in cell_items.
+    inline static std::vector<std::size_t> cell_fill;    //  Used when filling the cells.
+    inline static std::vector<std::size_t> cell_items;   //  Items in each cell.
+    inline static std::vector<float> nearest_dist;       //  Distances for nearest queries.
+
+    inline static uint32_t stamp = 0;    //  Current query stamp.
+    inline static bool built = false;    //  Index has been built.
+    inline static int64_t built_at = 0;  //  Engine time the index was built.
+};
+
+template <> bool manager<spatial>::initialized = false;
+
+}  //  end namespace wte::mgr
+
+#endif
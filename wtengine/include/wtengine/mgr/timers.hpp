@@ -0,0 +1,251 @@
+/*
+ * wtengine
+ * --------
+ * By Matthew Evans
+ * See LICENSE.md for copyright information.
+ */
+
+#if !defined(WTE_MGR_TIMERS_HPP)
+#define WTE_MGR_TIMERS_HPP
+
+#include <vector>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+
+#include "wtengine/mgr/manager.hpp"
+
+#include "wtengine/_globals/engine_time.hpp"
+#include "wtengine/mgr/world.hpp"
+
+namespace wte {
+  class engine;
+}
+
+namespace wte::sys {
+  class logic;
+}
+
+namespace wte::mgr {
+
+/*!
+ * \struct timer_handle
+ * \brief Reference to a scheduled timer.  Used to cancel it.
+ */
+struct timer_handle {
+  std::size_t index;    //!<  Timer slot.
+  uint32_t generation;  //!<  Use of the slot.  Stale handles are ignored.
+};
+
+/*!
+ * \class timers
+ * \brief Call functions for entities at a future tick.
+ *
+ * Timers are stored in a hashed wheel, so scheduling and canceling do not
+ * depend on the number of timers.  Due timers are called by the logic system
+ * at the start of its run, in the order they were scheduled.
+ *
+ * Timers are not removed when their entity is deleted.  Cancel them first.
+ */
+class timers final : private manager<timers> {
+  friend class wte::engine;
+  friend class wte::sys::logic;
+
+  public:
+    /*!
+     * \brief Call a function after a number of ticks.
+     * \param ticks Ticks from now.  At least one.
+     * \param e_id Entity ID passed to the function.
+     * \param func Function to call.
+     * \return Handle to cancel the timer.
+     */
+    static timer_handle schedule(
+      const int64_t& ticks,
+      const entity_id& e_id,
+      const std::function<void(const entity_id&)>& func
+    ) {
+      return schedule_at(engine_time::check() + std::max(ticks, (int64_t)1), e_id, func);
+    };
+
+    /*!
+     * \brief Call a function at a tick.
+     *
+     * Ticks already passed are called on the next run.
+     *
+     * \param tick Tick to call the function.
+     * \param e_id Entity ID passed to the function.
+     * \param func Function to call.
+     * \return Handle to cancel the timer.
+     */
+    static timer_handle schedule_at(
+      const int64_t& tick,
+      const entity_id& e_id,
+      const std::function<void(const entity_id&)>& func
+    ) {
+      if(heads.empty()) {
+        heads.assign(WHEEL_SIZE, NONE);
+        tails.assign(WHEEL_SIZE, NONE);
+      }
+
+      std::size_t idx;
+      if(free_nodes.empty()) {
+        idx = nodes.size();
+        nodes.emplace_back();
+      } else {
+        idx = free_nodes.back();
+        free_nodes.pop_back();
+      }
+
+      node& n = nodes[idx];
+      n.tick = std::max(tick, next_tick);
+      n.e_id = e_id;
+      n.func = func;
+      n.state = node_state::queued;
+
+      //  Add to the end of the slot so timers run in order.
+      const std::size_t slot = static_cast<std::size_t>(n.tick) & (WHEEL_SIZE - 1);
+      n.next = NONE;
+      n.prev = tails[slot];
+      if(tails[slot] == NONE) heads[slot] = idx;
+      else nodes[tails[slot]].next = idx;
+      tails[slot] = idx;
+      count++;
+
+      return { idx, n.generation };
+    };
+
+    /*!
+     * \brief Cancel a timer.
+     * \param h Handle of the timer.
+     * \return True if canceled, false if already called or canceled.
+     */
+    static bool cancel(const timer_handle& h) {
+      if(!pending(h)) return false;
+      if(nodes[h.index].state == node_state::queued) unlink(h.index);
+      release(h.index);
+      return true;
+    };
+
+    /*!
+     * \brief Check if a timer is waiting to be called.
+     * \param h Handle of the timer.
+     * \return True if waiting, false if not.
+     */
+    static bool pending(const timer_handle& h) {
+      return (h.index < nodes.size() &&
+              nodes[h.index].generation == h.generation &&
+              nodes[h.index].state != node_state::free);
+    };
+
+    /*!
+     * \brief Get the number of waiting timers.
+     * \return Number of timers.
+     */
+    static std::size_t size(void) { return count; };
+
+  private:
+    timers() = default;
+    ~timers() = default;
+
+    enum class node_state { free, queued, firing };
+
+    struct node {
+      int64_t tick = 0;
+      entity_id e_id = 0;
+      std::function<void(const entity_id&)> func;
+      std::size_t prev = NONE, next = NONE;
+      uint32_t generation = 0;
+      node_state state = node_state::free;
+    };
+
+    //  Remove all timers.
+    static void clear(void) {
+      nodes.clear();
+      free_nodes.clear();
+      heads.assign(WHEEL_SIZE, NONE);
+      tails.assign(WHEEL_SIZE, NONE);
+      firing.clear();
+      next_tick = 0;
+      count = 0;
+    };
+
+    /*
+     * Call the timers due up to a tick.
+     * Only visits the slots for the ticks passed since the last call.
+     */
+    static void advance(const int64_t& now) {
+      if(now < next_tick) return;
+      if(count == 0 || heads.empty()) {
+        next_tick = now + 1;
+        return;
+      }
+      //  Each slot only needs to be visited once.
+      int64_t t = std::max(next_tick, now - (int64_t)WHEEL_SIZE + 1);
+      next_tick = now + 1;
+
+      firing.clear();
+      for(; t <= now; t++) {
+        const std::size_t slot = static_cast<std::size_t>(t) & (WHEEL_SIZE - 1);
+        for(std::size_t idx = heads[slot]; idx != NONE;) {
+          const std::size_t next = nodes[idx].next;
+          if(nodes[idx].tick <= t) {
+            unlink(idx);
+            nodes[idx].state = node_state::firing;
+            firing.push_back({ idx, nodes[idx].generation });
+          }
+          idx = next;
+        }
+      }
+
+      //  Timers may be scheduled or canceled while calling.
+      for(std::size_t i = 0; i < firing.size(); i++) {
+        const timer_handle h = firing[i];
+        if(!pending(h)) continue;
+        const entity_id e_id = nodes[h.index].e_id;
+        const std::function<void(const entity_id&)> func = std::move(nodes[h.index].func);
+        release(h.index);
+        func(e_id);
+      }
+      firing.clear();
+    };
+
+    //  Remove a node from its slot.
+    static void unlink(const std::size_t& idx) {
+      node& n = nodes[idx];
+      const std::size_t slot = static_cast<std::size_t>(n.tick) & (WHEEL_SIZE - 1);
+      if(n.prev == NONE) heads[slot] = n.next;
+      else nodes[n.prev].next = n.next;
+      if(n.next == NONE) tails[slot] = n.prev;
+      else nodes[n.next].prev = n.prev;
+      n.prev = n.next = NONE;
+    };
+
+    //  Free a node for reuse.  Old handles to it become stale.
+    static void release(const std::size_t& idx) {
+      node& n = nodes[idx];
+      n.func = nullptr;
+      n.state = node_state::free;
+      n.generation++;
+      free_nodes.push_back(idx);
+      count--;
+    };
+
+    inline static const std::size_t WHEEL_SIZE = 256;  //  Slots in the wheel.  Power of two.
+    inline static const std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+    inline static std::vector<node> nodes;              //  Timers.
+    inline static std::vector<std::size_t> free_nodes;  //  Unused timers.
+    inline static std::vector<std::size_t> heads;       //  First timer in each slot.
+    inline static std::vector<std::size_t> tails;       //  Last timer in each slot.
+    inline static std::vector<timer_handle> firing;     //  Timers being called.
+    inline static int64_t next_tick = 0;                //  Next tick to process.
+    inline static std::size_t count = 0;                //  Waiting timers.
+};
+
+template <> bool manager<timers>::initialized = false;
+
+}  //  end namespace wte::mgr
+
+#endif
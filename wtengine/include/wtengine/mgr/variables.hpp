@@ -161,6 +161,7 @@ class variables final : private manager<variables> {
     ) {
       verify<T>();
       auto ret = _map.insert(std::make_pair(var, std::make_any<T>(val)));
+      if(ret.second) _versions[var]++;
       return ret.second;
     };
 
@@ -184,6 +185,7 @@ class variables final : private manager<variables> {
       auto it = _map.find(var);
       if(it != _map.end()) {
         _map.erase(it);
+        _versions[var]++;
         return true;
       }
       return false;
@@ -203,6 +205,7 @@ class variables final : private manager<variables> {
       verify<T>();
       try {
         _map.at(var) = std::make_any<T>(val);
+        _versions[var]++;
       } catch(std::out_of_range& e) {
         std::string err_msg = "Could not set variable: " + var;
         throw engine_exception(err_msg.c_str(), "variables", engine_time::check());
@@ -231,6 +234,19 @@ class variables final : private manager<variables> {
       }
     };
 
+    /*!
+     * \brief Get the version of a variable.
+     *
+     * Counts each time the variable is registered, set or deleted.
+     * Used to check if a variable changed without reading its value.
+     * \param var Variable name.
+     * \return Version of the variable, zero if it was never registered.
+     */
+    static std::size_t get_version(const std::string& var) {
+      auto it = _versions.find(var);
+      return (it == _versions.end() ? 0 : it->second);
+    };
+
   private:
     variables() = default;
     ~variables() = default;
@@ -259,6 +275,7 @@ class variables final : private manager<variables> {
 
     inline static std::string data_file_name = "game.cfg";  //  File to save variables to.
     inline static std::map<const std::string, std::any> _map;  //  Map of variables.
+    inline static std::map<const std::string, std::size_t> _versions;  //  Version of each variable.
 };
 
 template <> bool manager<variables>::initialized = false;
@@ -13,6 +13,7 @@
 #include <vector>
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <iterator>
 #include <algorithm>
@@ -143,6 +144,8 @@ class world final : private manager<world> {
 
       _world.erase(e_id);      //  Remove all associated componenets.
       entity_vec.erase(e_it);  //  Delete the entity.
+      if(sleeping.erase(e_id) > 0) sleep_version++;
+      structure_version++;
 
       return true;
     };
@@ -286,6 +289,7 @@ class world final : private manager<world> {
       }
 
       _world.insert(std::make_pair(e_id, std::make_shared<T>(args...)));
+      structure_version++;
       return true;
     };
 
@@ -303,6 +307,7 @@ class world final : private manager<world> {
       for(auto it = results.first; it != results.second; it++) {
         if(std::dynamic_pointer_cast<T>(it->second)) {
           it = _world.erase(it);
+          structure_version++;
           return true;
         }
       }
@@ -399,6 +404,55 @@ class world final : private manager<world> {
       return temp_components;
     };
 
+    /*!
+     * \brief Get the structure version of the world.
+     *
+     * Changes when components are added or deleted.
+     * Systems can keep component lists between ticks until this changes.
+     *
+     * \return Structure version.
+     */
+    static std::size_t get_version(void) { return structure_version; };
+
+    /*!
+     * \brief Put an entity to sleep.
+     *
+     * Sleeping entities are skipped by movement and treated as static by colision.
+     * The movement system puts entities to sleep when they stop moving,
+     * and wakes them when their components change.
+     *
+     * \param e_id Entity ID to put to sleep.
+     */
+    static void sleep(const entity_id& e_id) {
+      if(sleeping.insert(e_id).second) sleep_version++;
+    };
+
+    /*!
+     * \brief Wake a sleeping entity.
+     * \param e_id Entity ID to wake.
+     */
+    static void wake(const entity_id& e_id) {
+      if(sleeping.erase(e_id) > 0) sleep_version++;
+    };
+
+    /*!
+     * \brief Check if an entity is sleeping.
+     * \param e_id Entity ID to check.
+     * \return True if sleeping, false if not.
+     */
+    static bool is_sleeping(const entity_id& e_id) {
+      return (sleeping.find(e_id) != sleeping.end());
+    };
+
+    /*!
+     * \brief Get the sleep version of the world.
+     *
+     * Changes when an entity is put to sleep or woken.
+     *
+     * \return Sleep version.
+     */
+    static std::size_t get_sleep_version(void) { return sleep_version; };
+
     inline static const entity_id ENTITY_ERROR = 0;  //!<  Entity error code.
     inline static const entity_id ENTITY_START = 1;  //!<  Start of Entity counter.
     inline static const entity_id ENTITY_MAX =       //!<  Entity max value.
@@ -413,11 +467,17 @@ class world final : private manager<world> {
       entity_counter = ENTITY_START;
       entity_vec.clear();     //  Clear entities vector
       _world.clear();         //  Clear the world block
+      sleeping.clear();       //  Clear sleeping entities
+      structure_version++;
+      sleep_version++;
     };
 
     inline static entity_id entity_counter = ENTITY_START;  //  Last Entity ID used.
     inline static entities entity_vec;  //  Container for all entities.
     inline static world_map _world;     //  Container for all components.
+    inline static std::size_t structure_version = 0;  //  Changed when components are added or deleted.
+    inline static std::unordered_set<entity_id> sleeping;  //  Entities that are not moving.
+    inline static std::size_t sleep_version = 0;      //  Changed when entities sleep or wake.
 };
 
 template <> bool manager<world>::initialized = false;
@@ -9,7 +9,9 @@
 #define WTE_SYSTEMS_HPP
 
 #include "wtengine/sys/animate.hpp"
+#include "wtengine/sys/behaviors.hpp"
 #include "wtengine/sys/collision.hpp"
+#include "wtengine/sys/flocking.hpp"
 #include "wtengine/sys/logic.hpp"
 #include "wtengine/sys/movement.hpp"
 
@@ -9,6 +9,7 @@
 #define WTE_SYS_ANIMATE_HPP
 
 #include "wtengine/sys/system.hpp"
+#include "wtengine/mgr/renderer.hpp"
 
 namespace wte::sys::gfx {
 
@@ -25,13 +26,26 @@ class animate final : public system {
      * \brief Gets all animation components and processes their run members.
      * 
      * The entity must also have the visible component and is set visible to be drawn.
+     * Retained overlays are skipped until something they watch changes.
+     * With a render thread, only sprites are animated here.
      */
     void run(void) override {
+      //  Backgrounds and overlays draw, so they are animated by the render thread.
+      if constexpr (build_options.render_thread) {
+        component_container<cmp::gfx::sprite> sprite_components =
+          mgr::world::set_components<cmp::gfx::sprite>();
+
+        for(auto& it: sprite_components)
+          if(it.second->visible) it.second->animate(it.first);
+        mgr::gfx::renderer::defer_animations();
+        return;
+      }
+
       component_container<cmp::gfx::gfx> animation_components =
         mgr::world::set_components<cmp::gfx::gfx>();
 
       for(auto& it: animation_components)
-        if(it.second->visible) it.second->animate(it.first);
+        if(it.second->visible && it.second->needs_update()) it.second->animate(it.first);
     };
 };
 
@@ -0,0 +1,250 @@
+/*
+ * wtengine
+ * --------
+ * By Matthew Evans
+ * See LICENSE.md for copyright information.
+ */
+
+#if !defined(WTE_SYS_BEHAVIORS_HPP)
+#define WTE_SYS_BEHAVIORS_HPP
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+#include "wtengine/sys/system.hpp"
+#include "wtengine/_globals/bytecode.hpp"
+#include "wtengine/mgr/programs.hpp"
+
+namespace wte::sys {
+
+/*!
+ * \class behaviors
+ * \brief Runs the behavior programs of entities with behavior components.
+ *
+ * Entities are grouped by program and each program is run over its group in one loop.
+ * The groups are cached until components are added or deleted, or a program is loaded.
+ * Entities with a program that is not loaded are skipped.
+ *
+ * Fields of components the entity does not have read as zero and ignore writes.
+ * Changing a location, motion, physics or hitbox field wakes the entity.
+ *
+ * Sine and cosine use sim_math, and rand draws from a generator owned by the system,
+ * so runs with the same seed give the same results.
+ */
+class behaviors final : public system {
+  public:
+    /*!
+     * \brief Create the behaviors system.
+     */
+    behaviors() : behaviors(DEFAULT_SEED) {};
+
+    /*!
+     * \brief Create the behaviors system with a seed for rand.
+     * \param seed Seed for the random numbers.
+     */
+    behaviors(const uint32_t& seed) : system("behaviors"), rng(seed),
+      cached_version(0), cached_programs(0), cache_valid(false) {};
+
+    ~behaviors() = default;
+
+    /*!
+     * \brief Run the program of each entity with a behavior component.
+     */
+    void run(void) override {
+      if(!cache_valid ||
+         cached_version != mgr::world::get_version() ||
+         cached_programs != mgr::programs::get_version()) rebuild();
+
+      const float tick = static_cast<float>(engine_time::check());
+      for(auto& grp: groups) {
+        const bytecode::program& prog = mgr::programs::get(grp.program);
+        for(std::size_t i = grp.begin; i < grp.end; i++) {
+          if(agents[i].beh->enabled) execute(prog, agents[i], tick, rng);
+        }
+      }
+    };
+
+  private:
+    //  Entity and the components its program can access.
+    struct agent {
+      entity_id id;
+      std::size_t program;
+      cmp::comp_ptr<cmp::behavior> beh;
+      cmp::comp_ptr<cmp::location> loc;
+      cmp::comp_ptr<cmp::motion> mot;
+      cmp::comp_ptr<cmp::physics> phys;
+      cmp::comp_ptr<cmp::hitbox> hit;
+    };
+
+    //  Entities in agents that run the same program.
+    struct group {
+      std::size_t program;
+      std::size_t begin, end;
+    };
+
+    //  Find the entities with behaviors and group them by program.
+    void rebuild(void) {
+      const component_container<cmp::behavior> beh_components =
+        mgr::world::set_components<cmp::behavior>();
+      const component_container<cmp::location> loc_components =
+        mgr::world::set_components<cmp::location>();
+      const component_container<cmp::motion> mot_components =
+        mgr::world::set_components<cmp::motion>();
+      const component_container<cmp::physics> phys_components =
+        mgr::world::set_components<cmp::physics>();
+      const component_container<cmp::hitbox> hit_components =
+        mgr::world::set_components<cmp::hitbox>();
+
+      agents.clear();
+      for(auto& it: beh_components) {
+        if(!mgr::programs::exists(it.second->program)) continue;
+        agents.push_back({ it.first, mgr::programs::index(it.second->program), it.second,
+          find(loc_components, it.first), find(mot_components, it.first),
+          find(phys_components, it.first), find(hit_components, it.first) });
+      }
+      std::stable_sort(agents.begin(), agents.end(),
+        [](const agent& a, const agent& b) { return a.program < b.program; });
+
+      groups.clear();
+      for(std::size_t i = 0; i < agents.size(); i++) {
+        if(groups.empty() || groups.back().program != agents[i].program)
+          groups.push_back({ agents[i].program, i, i });
+        groups.back().end = i + 1;
+      }
+
+      cached_version = mgr::world::get_version();
+      cached_programs = mgr::programs::get_version();
+      cache_valid = true;
+    };
+
+    //  Find a component of an entity, or null.
+    template <typename T>
+    static cmp::comp_ptr<T> find(const component_container<T>& c, const entity_id& e_id) {
+      auto it = c.find(e_id);
+      return (it == c.end() ? nullptr : it->second);
+    };
+
+    //  Read a component field.
+    static float load(const agent& a, const bytecode::field& f) {
+      switch(f) {
+        case bytecode::field::pos_x: return a.loc ? static_cast<float>(a.loc->pos_x) : 0.0f;
+        case bytecode::field::pos_y: return a.loc ? static_cast<float>(a.loc->pos_y) : 0.0f;
+        case bytecode::field::direction: return a.mot ? static_cast<float>(a.mot->direction) : 0.0f;
+        case bytecode::field::x_vel: return a.mot ? static_cast<float>(a.mot->x_vel) : 0.0f;
+        case bytecode::field::y_vel: return a.mot ? static_cast<float>(a.mot->y_vel) : 0.0f;
+        case bytecode::field::accel_x: return a.phys ? static_cast<float>(a.phys->accel_x) : 0.0f;
+        case bytecode::field::accel_y: return a.phys ? static_cast<float>(a.phys->accel_y) : 0.0f;
+        case bytecode::field::drag: return a.phys ? static_cast<float>(a.phys->drag) : 0.0f;
+        case bytecode::field::max_speed: return a.phys ? static_cast<float>(a.phys->max_speed) : 0.0f;
+        case bytecode::field::mass: return a.phys ? static_cast<float>(a.phys->mass) : 0.0f;
+        case bytecode::field::width: return a.hit ? static_cast<float>(a.hit->width) : 0.0f;
+        case bytecode::field::height: return a.hit ? static_cast<float>(a.hit->height) : 0.0f;
+        case bytecode::field::solid: return (a.hit && a.hit->solid) ? 1.0f : 0.0f;
+      }
+      return 0.0f;
+    };
+
+    //  Write a component field.  Returns true if the value changed.
+    static bool store(const agent& a, const bytecode::field& f, const float& v) {
+      sim_float* target = nullptr;
+      switch(f) {
+        case bytecode::field::pos_x: if(a.loc) target = &a.loc->pos_x; break;
+        case bytecode::field::pos_y: if(a.loc) target = &a.loc->pos_y; break;
+        case bytecode::field::direction: if(a.mot) target = &a.mot->direction; break;
+        case bytecode::field::x_vel: if(a.mot) target = &a.mot->x_vel; break;
+        case bytecode::field::y_vel: if(a.mot) target = &a.mot->y_vel; break;
+        case bytecode::field::accel_x: if(a.phys) target = &a.phys->accel_x; break;
+        case bytecode::field::accel_y: if(a.phys) target = &a.phys->accel_y; break;
+        case bytecode::field::drag: if(a.phys) target = &a.phys->drag; break;
+        case bytecode::field::max_speed: if(a.phys) target = &a.phys->max_speed; break;
+        case bytecode::field::mass: if(a.phys) target = &a.phys->mass; break;
+        case bytecode::field::width: if(a.hit) target = &a.hit->width; break;
+        case bytecode::field::height: if(a.hit) target = &a.hit->height; break;
+        case bytecode::field::solid:
+          if(!a.hit || a.hit->solid == (v != 0.0f)) return false;
+          a.hit->solid = (v != 0.0f);
+          return true;
+      }
+      if(!target) return false;
+      const sim_float value = v;
+      if(*target == value) return false;
+      *target = value;
+      return true;
+    };
+
+    //  Run a program for one entity.
+    static void execute(const bytecode::program& prog, const agent& a, const float& tick, std::mt19937& rng) {
+      using bytecode::opcode;
+      float r[bytecode::REGISTERS] = {};
+      float* vars = a.beh->vars.data();
+      const bytecode::instruction* code = prog.code.data();
+      const std::size_t size = prog.code.size();
+      bool changed = false;
+
+      //  Stop runaway loops.
+      for(std::size_t pc = 0, steps = 0; pc < size && steps < MAX_STEPS; steps++) {
+        const bytecode::instruction& ins = code[pc++];
+        switch(ins.op) {
+          case opcode::nop: break;
+          case opcode::end: pc = size; break;
+          case opcode::li: r[ins.a] = ins.imm; break;
+          case opcode::mov: r[ins.a] = r[ins.b]; break;
+          case opcode::ld: r[ins.a] = load(a, static_cast<bytecode::field>(ins.i)); break;
+          case opcode::st: changed |= store(a, static_cast<bytecode::field>(ins.i), r[ins.a]); break;
+          case opcode::ldv: r[ins.a] = vars[ins.i]; break;
+          case opcode::stv: vars[ins.i] = r[ins.a]; break;
+          case opcode::add: r[ins.a] = r[ins.b] + r[ins.c]; break;
+          case opcode::sub: r[ins.a] = r[ins.b] - r[ins.c]; break;
+          case opcode::mul: r[ins.a] = r[ins.b] * r[ins.c]; break;
+          case opcode::div: r[ins.a] = (r[ins.c] != 0.0f ? r[ins.b] / r[ins.c] : 0.0f); break;
+          case opcode::min: r[ins.a] = std::min(r[ins.b], r[ins.c]); break;
+          case opcode::max: r[ins.a] = std::max(r[ins.b], r[ins.c]); break;
+          case opcode::addi: r[ins.a] = r[ins.b] + ins.imm; break;
+          case opcode::muli: r[ins.a] = r[ins.b] * ins.imm; break;
+          case opcode::neg: r[ins.a] = -r[ins.b]; break;
+          case opcode::abs: r[ins.a] = std::abs(r[ins.b]); break;
+          case opcode::sqrt: r[ins.a] = std::sqrt(std::max(r[ins.b], 0.0f)); break;
+          case opcode::sin: r[ins.a] = static_cast<float>(sim_math::sin(sim_float(r[ins.b]))); break;
+          case opcode::cos: r[ins.a] = static_cast<float>(sim_math::cos(sim_float(r[ins.b]))); break;
+          case opcode::floor: r[ins.a] = std::floor(r[ins.b]); break;
+          case opcode::lt: r[ins.a] = (r[ins.b] < r[ins.c] ? 1.0f : 0.0f); break;
+          case opcode::le: r[ins.a] = (r[ins.b] <= r[ins.c] ? 1.0f : 0.0f); break;
+          case opcode::eq: r[ins.a] = (r[ins.b] == r[ins.c] ? 1.0f : 0.0f); break;
+          case opcode::ne: r[ins.a] = (r[ins.b] != r[ins.c] ? 1.0f : 0.0f); break;
+          case opcode::jmp: pc = ins.i; break;
+          case opcode::jz: if(r[ins.a] == 0.0f) pc = ins.i; break;
+          case opcode::jnz: if(r[ins.a] != 0.0f) pc = ins.i; break;
+          case opcode::tick: r[ins.a] = tick; break;
+          //  Top 24 bits, so the value is exact in a float and below one.
+          case opcode::rand: r[ins.a] = static_cast<float>(rng() >> 8) / 16777216.0f; break;
+          case opcode::send: {
+            const bytecode::send_args& s = prog.sends[ins.i];
+            const std::string name = mgr::world::get_name(a.id);
+            mgr::messages::add(message(s.sys, (s.to == "$self" ? name : s.to), name, s.cmd, s.args));
+            break;
+          }
+        }
+      }
+
+      if(changed) mgr::world::wake(a.id);
+    };
+
+    inline static const std::size_t MAX_STEPS = 4096;  //  Instructions per entity each tick.
+    inline static const uint32_t DEFAULT_SEED = 5489;  //  Seed when none is given.
+
+    std::mt19937 rng;             //  Random numbers for rand.
+
+    std::vector<agent> agents;    //  Entities with behaviors, sorted by program.
+    std::vector<group> groups;    //  Entities running each program.
+    std::size_t cached_version;   //  World version the entities were found for.
+    std::size_t cached_programs;  //  Programs version the entities were found for.
+    bool cache_valid;
+};
+
+}  //  end namespace wte::sys
+
+#endif
@@ -8,64 +8,431 @@
 #if !defined(WTE_SYS_COLISION_HPP)
 #define WTE_SYS_COLISION_HPP
 
+#include <string>
+#include <vector>
+#include <iterator>
+#include <utility>
+#include <tuple>
+#include <functional>
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <thread>
+
 #include "wtengine/sys/system.hpp"
+#include "wtengine/_globals/thread_pool.hpp"
 
 namespace wte::sys {
 
 /*!
  * \class colision
  * \brief Selects components by team and tests for colisions.
+ *
+ * Hitboxes flagged as fast are also swept from their previous location.
+ * Colisions are stored in a contact buffer that can be read after the system runs.
+ * Contacts are tracked across ticks, so only changes are reported by default.
+ *
+ * Pairs are found with a sort and sweep along the x axis, then tested.
+ * Pairs of sleeping entities are not tested, their contacts are kept from the last tick.
+ * Testing can be split across threads, which are kept between ticks.
+ * Contacts are sorted after testing, so the results are the same for any number of threads.
  */
 class colision final : public system {
   public:
-    colision() : system("colision") {};
+    /*!
+     * \enum contact_phase
+     * \brief State of a contact between two entities.
+     */
+    enum class contact_phase {
+      enter,  //!<  Entities started touching this tick.
+      stay,   //!<  Entities were already touching.  Only reported if enabled.
+      exit    //!<  Entities stopped touching this tick.
+    };
+
+    /*!
+     * \struct contact
+     * \brief Stores a colision between two entities.
+     */
+    struct contact {
+      entity_id entity_a;  //!<  First entity.  Always the lower ID.
+      entity_id entity_b;  //!<  Second entity.
+      std::size_t team_a;  //!<  Team of the first entity.
+      std::size_t team_b;  //!<  Team of the second entity.
+      sim_float depth;     //!<  Overlap depth at the end of the tick.  Zero for swept hits.
+      sim_float toi;       //!<  Time of impact during the tick, from 0 to 1.
+      contact_phase phase; //!<  Enter, stay or exit.
+    };
+
+    /*!
+     * \brief Create the colision system.  Sends colision messages.
+     */
+    colision() : system("colision"), send_messages(true), report_stay(false), num_threads(1) {};
+
+    /*!
+     * \brief Create the colision system, set if colision messages are sent.
+     * \param m Send colision messages to the entities for existing dispatchers.
+     */
+    colision(const bool& m) : system("colision"), send_messages(m), report_stay(false), num_threads(1) {};
+
+    /*!
+     * \brief Create the colision system, set messages and stay reporting.
+     * \param m Send colision messages to the entities for existing dispatchers.
+     * \param s Report contacts every tick while the entities are touching.
+     */
+    colision(
+      const bool& m,
+      const bool& s
+    ) : system("colision"), send_messages(m), report_stay(s), num_threads(1) {};
+
+    /*!
+     * \brief Create the colision system, set messages, stay reporting and threads.
+     * \param m Send colision messages to the entities for existing dispatchers.
+     * \param s Report contacts every tick while the entities are touching.
+     * \param t Number of threads to test with.  Zero uses the hardware thread count.
+     */
+    colision(
+      const bool& m,
+      const bool& s,
+      const std::size_t& t
+    ) : system("colision"), send_messages(m), report_stay(s),
+    num_threads(t > 0 ? t : std::max(std::thread::hardware_concurrency(), 1u)) {};
+
     ~colision() = default;
 
     /*!
      * \brief Selects components by team, then tests each team to see if there is a colision.
+     *
+     * Fast hitboxes that passed through another hitbox during the tick
+     * are reported in the order they were hit.
+     * Their pairs are kept as touching, so the next tick reports the exit.
      */
     void run(void) override {
       const_component_container<cmp::hitbox> hitbox_components =
         mgr::world::get_components<cmp::hitbox>();
 
-      for(auto& it_a: hitbox_components) {
-        for(auto& it_b: hitbox_components) {
-          cmp::const_comp_ptr<cmp::location> temp_location_a =
-            mgr::world::get_component<cmp::location>(it_a.first);
-          cmp::const_comp_ptr<cmp::location> temp_location_b =
-            mgr::world::get_component<cmp::location>(it_b.first);
-
-          /*
-          * Only test if:  Not the same entity.
-          *                Entities are on different teams.
-          *                Both entities are solid.
-          */
-          if(
-            it_a.first != it_b.first &&
-            it_a.second->team != it_b.second->team &&
-            it_a.second->solid && it_b.second->solid
-          ) {
-            //  Use AABB to test colision
-            if(
-              temp_location_a->pos_x < temp_location_b->pos_x + it_b.second->width &&
-              temp_location_a->pos_x + it_a.second->width > temp_location_b->pos_x &&
-              temp_location_a->pos_y < temp_location_b->pos_y + it_b.second->height &&
-              temp_location_a->pos_y + it_a.second->height > temp_location_b->pos_y
-            ) {
-              //  Send a message that two entities colided.
-              //  Each entity will get a colision message.
-              //  Ex:  A hit B, B hit A.
-              mgr::messages::add(
-                message("entities",
-                        mgr::world::get_name(it_a.first),
-                        mgr::world::get_name(it_b.first),
-                        "colision", "")
-              );
-            }
-          } //  End skip self check
-        } //  End it_b loop
-      } //  End it_a loop
+      //  Gather the hitboxes and their locations once.
+      bodies.clear();
+      for(auto& it: hitbox_components) {
+        cmp::const_comp_ptr<cmp::location> temp_location =
+          mgr::world::get_component<cmp::location>(it.first);
+        bodies.push_back({
+          it.first, temp_location->pos_x, temp_location->pos_y,
+          temp_location->pos_x, temp_location->pos_y,
+          it.second->width, it.second->height,
+          it.second->team, it.second->solid, it.second->fast, false,
+          mgr::world::is_sleeping(it.first), 0.0f, 0.0f
+        });
+      }
+
+      //  Set the previous location of fast hitboxes that were solid last tick.
+      for(auto& it: bodies) {
+        if(!it.fast || !it.solid) continue;
+        auto last = std::lower_bound(last_positions.begin(), last_positions.end(), it.id,
+          [](const last_position& a, const entity_id& b){ return a.id < b; });
+        if(last != last_positions.end() && last->id == it.id && last->solid) {
+          it.last_x = last->pos_x;
+          it.last_y = last->pos_y;
+          it.swept = true;
+        }
+      }
+
+      find_pairs();
+
+      //  Test the pairs, splitting them across threads if there are enough.
+      const std::size_t thread_count = std::max(
+        std::min(num_threads, candidates.size() / MIN_PAIRS_PER_THREAD), (std::size_t)1);
+      results.resize(thread_count);
+      const std::size_t chunk = (candidates.size() + thread_count - 1) / thread_count;
+      workers.run(thread_count, [this, chunk](const std::size_t& i) {
+        test_pairs(std::min(i * chunk, candidates.size()),
+                   std::min((i + 1) * chunk, candidates.size()), results[i]);
+      });
+
+      //  Merge the results and sort them so the order does not depend on the threads.
+      overlaps.clear();
+      swept_hits.clear();
+      for(std::size_t i = 0; i < thread_count; i++) {
+        overlaps.insert(overlaps.end(), results[i].overlaps.begin(), results[i].overlaps.end());
+        swept_hits.insert(swept_hits.end(), results[i].swept_hits.begin(), results[i].swept_hits.end());
+      }
+      //  Sleeping pairs were not tested, keep their contacts from last tick.
+      //  Swept hits are not touching, so they are not kept.
+      for(auto& it: active_pairs) {
+        if(it.second.toi < 1.0f) continue;
+        const body* a = find_body(it.first.first);
+        const body* b = find_body(it.first.second);
+        if(a && b && a->asleep && b->asleep && a->solid && b->solid) {
+          overlaps.push_back(it.second);
+          overlaps.back().phase = contact_phase::enter;
+        }
+      }
+      std::sort(overlaps.begin(), overlaps.end(),
+        [](const contact& a, const contact& b) {
+          return std::tie(a.entity_a, a.entity_b) < std::tie(b.entity_a, b.entity_b);
+        });
+
+      //  Compare against the pairs touching last tick.
+      _contacts.clear();
+      current_pairs.clear();
+      for(auto& it: overlaps) {
+        const entity_pair key = std::make_pair(it.entity_a, it.entity_b);
+        current_pairs.insert(std::make_pair(key, it));
+        if(active_pairs.find(key) == active_pairs.end()) {
+          _contacts.push_back(it);
+        } else if(report_stay) {
+          it.phase = contact_phase::stay;
+          _contacts.push_back(it);
+        }
+      }
+
+      //  Swept pairs are kept as touching, so the exit is reported next tick.
+      std::sort(swept_hits.begin(), swept_hits.end(),
+        [](const contact& a, const contact& b) {
+          return std::tie(a.toi, a.entity_a, a.entity_b) < std::tie(b.toi, b.entity_a, b.entity_b);
+        });
+      swept_contacts.clear();
+      for(auto& it: swept_hits) {
+        const entity_pair key = std::make_pair(it.entity_a, it.entity_b);
+        if(!current_pairs.insert(std::make_pair(key, it)).second) continue;
+        if(active_pairs.find(key) == active_pairs.end()) {
+          swept_contacts.push_back(it);
+        } else if(report_stay) {
+          it.phase = contact_phase::stay;
+          swept_contacts.push_back(it);
+        }
+      }
+
+      //  Pairs no longer touching are reported as exits.
+      const std::size_t exit_start = _contacts.size();
+      for(auto& it: active_pairs) {
+        if(current_pairs.find(it.first) == current_pairs.end()) {
+          contact temp_contact = it.second;
+          temp_contact.depth = 0.0f;
+          temp_contact.toi = 1.0f;
+          temp_contact.phase = contact_phase::exit;
+          _contacts.push_back(temp_contact);
+        }
+      }
+      //  Keep exits in entity order.
+      std::sort(std::next(_contacts.begin(), exit_start), _contacts.end(),
+        [](const contact& a, const contact& b) {
+          return std::tie(a.entity_a, a.entity_b) < std::tie(b.entity_a, b.entity_b);
+        });
+      std::swap(active_pairs, current_pairs);
+
+      //  Add swept hits in the order they happened during the tick.
+      _contacts.insert(_contacts.end(), swept_contacts.begin(), swept_contacts.end());
+
+      //  Store the current location of fast hitboxes for the next tick.
+      last_positions.clear();
+      for(auto& it: bodies) {
+        if(it.fast) last_positions.push_back({ it.id, it.pos_x, it.pos_y, it.solid });
+      }
+
+      if(send_messages) message_contacts();
+    };
+
+    /*!
+     * \brief Get the contacts found the last time the system ran.
+     * \return Contact buffer.  Valid until the system runs again.
+     */
+    static const std::vector<contact>& get_contacts(void) { return _contacts; };
+
+  private:
+    //  Hitbox and location data used for testing.
+    struct body {
+      entity_id id;
+      sim_float pos_x, pos_y;
+      sim_float last_x, last_y;
+      sim_float width, height;
+      std::size_t team;
+      bool solid, fast, swept;
+      bool asleep;         //  Entity is sleeping and has not moved.
+      sim_float min_x, max_x;  //  Extent on the x axis, including the sweep.
+    };
+
+    //  Find a body by entity.  Bodies are in entity order.
+    const body* find_body(const entity_id& e_id) const {
+      auto it = std::lower_bound(bodies.begin(), bodies.end(), e_id,
+        [](const body& a, const entity_id& b){ return a.id < b; });
+      if(it == bodies.end() || it->id != e_id) return nullptr;
+      return &(*it);
+    };
+
+    //  Contacts found by one thread.
+    struct pair_results {
+      std::vector<contact> overlaps;
+      std::vector<contact> swept_hits;
+    };
+
+    /*
+     * Sort and sweep along the x axis to find pairs that may be touching.
+     * Only solid hitboxes on different teams are paired.
+     * Pairs are stored with the lower entity first.
+     */
+    void find_pairs(void) {
+      order.clear();
+      for(std::size_t i = 0; i < bodies.size(); i++) {
+        if(!bodies[i].solid) continue;
+        bodies[i].min_x = std::min(bodies[i].pos_x, bodies[i].last_x);
+        bodies[i].max_x = std::max(bodies[i].pos_x, bodies[i].last_x) + bodies[i].width;
+        order.push_back(i);
+      }
+      std::sort(order.begin(), order.end(),
+        [this](const std::size_t& a, const std::size_t& b) {
+          return std::tie(bodies[a].min_x, a) < std::tie(bodies[b].min_x, b);
+        });
+
+      candidates.clear();
+      for(auto it_a = order.begin(); it_a != order.end(); it_a++) {
+        for(auto it_b = std::next(it_a); it_b != order.end(); it_b++) {
+          //  Sorted by the left edge, nothing past here can overlap.
+          if(bodies[*it_b].min_x > bodies[*it_a].max_x) break;
+          if(bodies[*it_a].team == bodies[*it_b].team) continue;
+          //  Neither has moved, so nothing changed.
+          if(bodies[*it_a].asleep && bodies[*it_b].asleep) continue;
+          //  Bodies are gathered in entity order, so the lower index is the lower entity.
+          candidates.push_back(std::make_pair(std::min(*it_a, *it_b), std::max(*it_a, *it_b)));
+        }
+      }
+    };
+
+    /*
+     * Test a range of pairs.
+     * Only reads the bodies and pairs, so ranges can be tested on different threads.
+     */
+    void test_pairs(const std::size_t& begin, const std::size_t& end, pair_results& res) const {
+      res.overlaps.clear();
+      res.swept_hits.clear();
+      for(std::size_t i = begin; i < end; i++) {
+        const body& a = bodies[candidates[i].first];
+        const body& b = bodies[candidates[i].second];
+        //  Use AABB to test colision
+        if(
+          a.pos_x < b.pos_x + b.width &&
+          a.pos_x + a.width > b.pos_x &&
+          a.pos_y < b.pos_y + b.height &&
+          a.pos_y + a.height > b.pos_y
+        ) {
+          //  Store the smallest overlap as the depth.
+          const sim_float depth = std::min(
+            std::min(a.pos_x + a.width - b.pos_x, b.pos_x + b.width - a.pos_x),
+            std::min(a.pos_y + a.height - b.pos_y, b.pos_y + b.height - a.pos_y));
+          res.overlaps.push_back({ a.id, b.id, a.team, b.team, depth, 1.0f, contact_phase::enter });
+        } else if(a.swept || b.swept) {
+          //  Not touching at the end of the tick, check if they passed through each other.
+          const sim_float toi = time_of_impact(a, b);
+          if(toi >= 0.0f)
+            res.swept_hits.push_back({ a.id, b.id, a.team, b.team, 0.0f, toi, contact_phase::enter });
+        }
+      }
+    };
+
+    //  Location of a fast hitbox at the end of the last tick.
+    struct last_position {
+      entity_id id;
+      sim_float pos_x, pos_y;
+      bool solid;
+    };
+
+    /*
+     * Container key for a pair of entities.
+     */
+    using entity_pair = std::pair<entity_id, entity_id>;
+
+    //  Hash a pair of entities.
+    struct pair_hash {
+      std::size_t operator()(const entity_pair& p) const {
+        return std::hash<entity_id>{}(p.first) ^ (std::hash<entity_id>{}(p.second) * 31);
+      }
+    };
+
+    /*
+     * Send a colision message to each entity in a contact.
+     * Ex:  A hit B, B hit A.
+     * Exits send colision_end, and skip entities that were deleted.
+     * Messages are added to the front of the queue, so add the last contact first.
+     */
+    static void message_contacts(void) {
+      for(auto it = _contacts.rbegin(); it != _contacts.rend(); it++) {
+        if(it->phase == contact_phase::exit) {
+          const bool exists_a = mgr::world::entity_exists(it->entity_a);
+          const bool exists_b = mgr::world::entity_exists(it->entity_b);
+          const std::string name_a = (exists_a ? mgr::world::get_name(it->entity_a) : "");
+          const std::string name_b = (exists_b ? mgr::world::get_name(it->entity_b) : "");
+          if(exists_b) mgr::messages::add(message("entities", name_b, name_a, "colision_end", ""));
+          if(exists_a) mgr::messages::add(message("entities", name_a, name_b, "colision_end", ""));
+        } else {
+          const std::string name_a = mgr::world::get_name(it->entity_a);
+          const std::string name_b = mgr::world::get_name(it->entity_b);
+          mgr::messages::add(message("entities", name_b, name_a, "colision", ""));
+          mgr::messages::add(message("entities", name_a, name_b, "colision", ""));
+        }
+      }
     };
+
+    /*
+     * Swept AABB test using the movement of both hitboxes during the tick.
+     * Returns the time of impact from 0 to 1, or -1 if they did not touch.
+     */
+    static sim_float time_of_impact(const body& a, const body& b) {
+      //  Movement of A relative to B.
+      const sim_float vel_x = (a.pos_x - a.last_x) - (b.pos_x - b.last_x);
+      const sim_float vel_y = (a.pos_y - a.last_y) - (b.pos_y - b.last_y);
+
+      sim_float entry_x, exit_x, entry_y, exit_y;
+      if(!slab(a.last_x, a.width, b.last_x, b.width, vel_x, entry_x, exit_x)) return -1.0f;
+      if(!slab(a.last_y, a.height, b.last_y, b.height, vel_y, entry_y, exit_y)) return -1.0f;
+
+      const sim_float entry = std::max(entry_x, entry_y);
+      const sim_float exit = std::min(exit_x, exit_y);
+      if(entry >= exit || entry < 0.0f || entry > 1.0f) return -1.0f;
+      return entry;
+    };
+
+    //  Find when the hitboxes enter and exit each other on one axis.
+    static bool slab(
+      const sim_float& a_pos, const sim_float& a_size,
+      const sim_float& b_pos, const sim_float& b_size,
+      const sim_float& vel, sim_float& entry, sim_float& exit
+    ) {
+      if(vel == 0.0f) {
+        //  Not moving on this axis, must already overlap.
+        if(a_pos < b_pos + b_size && a_pos + a_size > b_pos) {
+          entry = std::numeric_limits<sim_float>::lowest();
+          exit = std::numeric_limits<sim_float>::max();
+          return true;
+        }
+        return false;
+      }
+      const sim_float near_t = (vel > 0.0f ? b_pos - (a_pos + a_size) : b_pos + b_size - a_pos) / vel;
+      const sim_float far_t = (vel > 0.0f ? b_pos + b_size - a_pos : b_pos - (a_pos + a_size)) / vel;
+      entry = near_t;
+      exit = far_t;
+      return true;
+    };
+
+    const bool send_messages;  //  Flag to send colision messages.
+    const bool report_stay;    //  Flag to report contacts every tick.
+    const std::size_t num_threads;  //  Max number of threads to test with.
+
+    //  Fewest pairs to give each thread.  Below this, threads cost more than they save.
+    inline static const std::size_t MIN_PAIRS_PER_THREAD = 512;
+
+    std::vector<body> bodies;                    //  Hitboxes being tested this tick.
+    std::vector<last_position> last_positions;  //  Fast hitbox locations, sorted by entity.
+    std::vector<contact> overlaps;              //  Hitboxes touching at the end of this tick.
+    std::vector<contact> swept_hits;            //  Swept hits found this tick.
+    std::vector<contact> swept_contacts;        //  Swept hits to report this tick.
+    std::vector<std::size_t> order;             //  Solid bodies sorted along the x axis.
+    std::vector<std::pair<std::size_t, std::size_t>> candidates;  //  Pairs to test.
+    std::vector<pair_results> results;          //  Contacts found by each thread.
+    thread_pool workers;                        //  Threads testing the pairs.
+
+    //  Pairs touching last tick and this tick.
+    std::unordered_map<entity_pair, contact, pair_hash> active_pairs, current_pairs;
+
+    inline static std::vector<contact> _contacts;  //  Contacts found this tick.
 };
 
 }  //  end namespace wte::sys
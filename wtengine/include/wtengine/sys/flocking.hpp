@@ -0,0 +1,267 @@
+/*
+ * wtengine
+ * --------
+ * By Matthew Evans
+ * See LICENSE.md for copyright information.
+ */
+
+#if !defined(WTE_SYS_FLOCKING_HPP)
+#define WTE_SYS_FLOCKING_HPP
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <cmath>
+
+#include "wtengine/sys/system.hpp"
+#include "wtengine/_globals/thread_pool.hpp"
+
+namespace wte::sys {
+
+/*!
+ * \class flocking
+ * \brief Steers entities with steering components and writes their velocity.
+ *
+ * Each tick the entities are copied into packed arrays and put in a grid sized to the
+ * largest steering radius, so only the nearby cells are searched for neighbors.
+ * The grid is kept by the system, because it is read by several threads at once.
+ *
+ * Steering can be split across threads, which are kept between ticks.  Each entity's
+ * result only depends on the state at the start of the tick, so it is the same for
+ * any number of threads.
+ */
+class flocking final : public system {
+  public:
+    /*!
+     * \brief Create the flocking system.  Runs on one thread.
+     */
+    flocking() : system("flocking"), num_threads(1), cached_version(0), cache_valid(false) {};
+
+    /*!
+     * \brief Create the flocking system, set the number of threads.
+     * \param t Number of threads to steer with.  Zero uses the hardware thread count.
+     */
+    flocking(const std::size_t& t) : system("flocking"),
+    num_threads(t > 0 ? t : std::max(std::thread::hardware_concurrency(), 1u)),
+    cached_version(0), cache_valid(false) {};
+
+    ~flocking() = default;
+
+    /*!
+     * \brief Steer all entities with a steering, location and motion component.
+     */
+    void run(void) override {
+      if(!cache_valid || cached_version != mgr::world::get_version()) rebuild();
+      gather();
+      if(count == 0) return;
+      build_grid();
+
+      //  Steer, splitting the entities across threads if there are enough.
+      const std::size_t thread_count = std::max(
+        std::min(num_threads, count / MIN_AGENTS_PER_THREAD), (std::size_t)1);
+      const std::size_t chunk = (count + thread_count - 1) / thread_count;
+      workers.run(thread_count, [this, chunk](const std::size_t& i) {
+        steer(std::min(i * chunk, count), std::min((i + 1) * chunk, count));
+      });
+
+      //  Write the new velocities.
+      for(std::size_t i = 0; i < count; i++) {
+        if(out_x[i] == vel_x[i] && out_y[i] == vel_y[i]) continue;
+        agents[i].mot->set_velocity(out_x[i], out_y[i]);
+        mgr::world::wake(agents[i].id);
+      }
+    };
+
+  private:
+    struct agent {
+      entity_id id;
+      cmp::comp_ptr<cmp::steering> steer;
+      cmp::comp_ptr<cmp::location> loc;
+      cmp::comp_ptr<cmp::motion> mot;
+    };
+
+    //  Find the entities to steer.
+    void rebuild(void) {
+      const component_container<cmp::steering> steer_components =
+        mgr::world::set_components<cmp::steering>();
+      const component_container<cmp::location> loc_components =
+        mgr::world::set_components<cmp::location>();
+      const component_container<cmp::motion> mot_components =
+        mgr::world::set_components<cmp::motion>();
+
+      all_agents.clear();
+      for(auto& it: steer_components) {
+        auto loc = loc_components.find(it.first);
+        auto mot = mot_components.find(it.first);
+        if(loc == loc_components.end() || mot == mot_components.end()) continue;
+        all_agents.push_back({ it.first, it.second, loc->second, mot->second });
+      }
+
+      cached_version = mgr::world::get_version();
+      cache_valid = true;
+    };
+
+    //  Copy the enabled entities into the packed arrays.
+    void gather(void) {
+      agents.clear();
+      for(auto& it: all_agents) if(it.steer->enabled) agents.push_back(it);
+      count = agents.size();
+
+      pos_x.resize(count); pos_y.resize(count);
+      vel_x.resize(count); vel_y.resize(count);
+      out_x.resize(count); out_y.resize(count);
+      radius.resize(count); flock.resize(count);
+      for(std::size_t i = 0; i < count; i++) {
+        const cmp::steering& s = *agents[i].steer;
+        cmp::motion& m = *agents[i].mot;
+        m.update_direction();
+        pos_x[i] = agents[i].loc->pos_x;
+        pos_y[i] = agents[i].loc->pos_y;
+        vel_x[i] = m.dir_x * m.x_vel;
+        vel_y[i] = m.dir_y * m.y_vel;
+        radius[i] = s.radius;
+        flock[i] = s.flock;
+      }
+    };
+
+    //  Sort the entities into grid cells.
+    void build_grid(void) {
+      float lx = static_cast<float>(pos_x[0]), hx = lx;
+      float ly = static_cast<float>(pos_y[0]), hy = ly;
+      float max_radius = 0.0f;
+      for(std::size_t i = 0; i < count; i++) {
+        lx = std::min(lx, static_cast<float>(pos_x[i]));
+        hx = std::max(hx, static_cast<float>(pos_x[i]));
+        ly = std::min(ly, static_cast<float>(pos_y[i]));
+        hy = std::max(hy, static_cast<float>(pos_y[i]));
+        max_radius = std::max(max_radius, static_cast<float>(radius[i]));
+      }
+
+      //  Cells are at least the largest radius, so neighbors are in the next cells.
+      cell_size = std::max({ max_radius, 1.0f,
+        (hx - lx) / (MAX_CELLS - 1), (hy - ly) / (MAX_CELLS - 1) });
+      origin_x = lx;
+      origin_y = ly;
+      grid_w = static_cast<int>((hx - lx) / cell_size) + 1;
+      grid_h = static_cast<int>((hy - ly) / cell_size) + 1;
+
+      cell_of.resize(count);
+      cell_start.assign(grid_w * grid_h + 1, 0);
+      for(std::size_t i = 0; i < count; i++) {
+        cell_of[i] = cell_y(pos_y[i]) * grid_w + cell_x(pos_x[i]);
+        cell_start[cell_of[i] + 1]++;
+      }
+      for(std::size_t c = 1; c < cell_start.size(); c++) cell_start[c] += cell_start[c - 1];
+      cell_fill.assign(cell_start.begin(), cell_start.end() - 1);
+      cell_items.resize(count);
+      for(std::size_t i = 0; i < count; i++) cell_items[cell_fill[cell_of[i]]++] = i;
+    };
+
+    int cell_x(const sim_float& x) const {
+      return std::min(std::max(static_cast<int>((static_cast<float>(x) - origin_x) / cell_size), 0), grid_w - 1);
+    };
+
+    int cell_y(const sim_float& y) const {
+      return std::min(std::max(static_cast<int>((static_cast<float>(y) - origin_y) / cell_size), 0), grid_h - 1);
+    };
+
+    /*
+     * Steer a range of entities.
+     * Only reads the packed arrays and grid, and writes its own part of the output.
+     */
+    void steer(const std::size_t begin, const std::size_t end) {
+      for(std::size_t i = begin; i < end; i++) {
+        const cmp::steering& s = *agents[i].steer;
+        //  Distances are compared in float, squared they can be past the range of fixed point.
+        const float r2 = static_cast<float>(radius[i]) * static_cast<float>(radius[i]);
+        const int cx = static_cast<int>(cell_of[i] % grid_w);
+        const int cy = static_cast<int>(cell_of[i] / grid_w);
+
+        sim_float sep_x = 0, sep_y = 0;
+        sim_float ali_x = 0, ali_y = 0;
+        sim_float coh_x = 0, coh_y = 0;
+        std::size_t neighbors = 0;
+
+        for(int y = std::max(cy - 1, 0); y <= std::min(cy + 1, grid_h - 1); y++) {
+          for(int x = std::max(cx - 1, 0); x <= std::min(cx + 1, grid_w - 1); x++) {
+            const std::size_t c = y * grid_w + x;
+            for(std::size_t k = cell_start[c]; k < cell_start[c + 1]; k++) {
+              const std::size_t j = cell_items[k];
+              if(j == i || flock[j] != flock[i]) continue;
+              const sim_float dx = pos_x[j] - pos_x[i];
+              const sim_float dy = pos_y[j] - pos_y[i];
+              const float fdx = static_cast<float>(dx), fdy = static_cast<float>(dy);
+              const float d2 = fdx * fdx + fdy * fdy;
+              if(d2 > r2 || d2 == 0.0f) continue;
+              sep_x -= sim_float(fdx / d2);
+              sep_y -= sim_float(fdy / d2);
+              ali_x += vel_x[j];
+              ali_y += vel_y[j];
+              coh_x += dx;
+              coh_y += dy;
+              neighbors++;
+            }
+          }
+        }
+
+        sim_float nx = vel_x[i], ny = vel_y[i];
+        if(neighbors > 0) {
+          const sim_float n = static_cast<sim_float>(neighbors);
+          sim_float fx = s.separation * sep_x * radius[i] +
+            s.alignment * (ali_x / n - vel_x[i]) + s.cohesion * (coh_x / n) / radius[i];
+          sim_float fy = s.separation * sep_y * radius[i] +
+            s.alignment * (ali_y / n - vel_y[i]) + s.cohesion * (coh_y / n) / radius[i];
+          limit(fx, fy, s.max_force);
+          nx += fx;
+          ny += fy;
+        }
+        limit(nx, ny, s.max_speed);
+        out_x[i] = nx;
+        out_y[i] = ny;
+      }
+    };
+
+    //  Scale a vector down to a max length.
+    static void limit(sim_float& x, sim_float& y, const sim_float& max) {
+      if(max <= 0) return;
+      const sim_float len = sim_math::sqrt(x * x + y * y);
+      if(len <= max) return;
+      x = x * max / len;
+      y = y * max / len;
+    };
+
+    const std::size_t num_threads;  //  Max number of threads to steer with.
+
+    //  Fewest entities to give each thread.  Below this, threads cost more than they save.
+    inline static const std::size_t MIN_AGENTS_PER_THREAD = 256;
+    inline static const int MAX_CELLS = 256;  //  Max cells per grid row or column.
+
+    std::vector<agent> all_agents;  //  Entities with steering.
+    std::vector<agent> agents;      //  Enabled entities this tick.
+    std::size_t count = 0;
+    std::size_t cached_version;     //  World version the entities were found for.
+    bool cache_valid;
+
+    //  Packed arrays for the entities.
+    std::vector<sim_float> pos_x, pos_y;
+    std::vector<sim_float> vel_x, vel_y;
+    std::vector<sim_float> out_x, out_y;
+    std::vector<sim_float> radius;
+    std::vector<unsigned int> flock;
+
+    //  Grid of the entities.
+    float cell_size = 1.0f;
+    float origin_x = 0.0f, origin_y = 0.0f;
+    int grid_w = 1, grid_h = 1;
+    std::vector<std::size_t> cell_of;     //  Cell of each entity.
+    std::vector<std::size_t> cell_start;  //  Start of each cell in cell_items.
+    std::vector<std::size_t> cell_fill;   //  Used when filling the cells.
+    std::vector<std::size_t> cell_items;  //  Entities in each cell.
+
+    thread_pool workers;  //  Threads steering the entities.
+};
+
+}  //  end namespace wte::sys
+
+#endif
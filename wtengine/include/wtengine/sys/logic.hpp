@@ -8,7 +8,14 @@
 #if !defined(WTE_SYS_LOGIC_HPP)
 #define WTE_SYS_LOGIC_HPP
 
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
 #include "wtengine/sys/system.hpp"
+#include "wtengine/mgr/timers.hpp"
 
 namespace wte::sys {
 
@@ -17,27 +24,209 @@ namespace wte::sys {
  * \brief Processes entities that have ai components.
  * 
  * Also sends messages to entities with dispatch components.
+ *
+ * AI with an interval above one are spread across ticks by entity.
+ * If a time budget is set, AI left when the budget runs out are run first next tick.
+ * AI run in order of the tick they became due, then by priority, so deferred AI are
+ * not passed by newer ones.
+ *
+ * Calls the timers due this tick before processing ai.
+ *
+ * Coroutine AI are only resumed when what they are waiting for happens.
+ * They are not counted against the time budget.
  */
 class logic final : public system {
   public:
-    logic() : system("logic") {};
+    /*!
+     * \struct schedule_stats
+     * \brief Logic scheduling information.
+     */
+    struct schedule_stats {
+      std::size_t ran;       //!<  AI run last tick.
+      std::size_t deferred;  //!<  AI moved to the next tick because the budget ran out.
+      std::size_t overruns;  //!<  Total ticks the budget ran out.
+      int64_t time_us;       //!<  Time spent last tick in microseconds.
+    };
+
+    /*!
+     * \brief Create the logic system with no time budget.
+     */
+    logic() : system("logic"), budget_us(0), cached_version(0), cache_valid(false) {};
+
+    /*!
+     * \brief Create the logic system with a time budget.
+     * \param b Time budget each tick in microseconds.  Zero for no budget.
+     */
+    logic(const int64_t& b) : system("logic"), budget_us(b), cached_version(0), cache_valid(false) {};
+
     ~logic() = default;
 
     /*!
      * \brief Finds all entities with an ai component and processes their logic.
      */
     void run(void) override {
-      //  Find the entities with the input handler component
-      component_container<cmp::ai> ai_components =
-        mgr::world::set_components<cmp::ai>();
+      mgr::timers::advance(engine_time::check());
+      if(!cache_valid || cached_version != mgr::world::get_version()) rebuild();
+      const int64_t tick = engine_time::check();
+
+      //  AI deferred last tick keep the tick they became due, so they go first.
+      due.clear();
+      for(auto& it: deferred) {
+        it.second->queued = tick;
+        due.push_back(it);
+      }
+      for(auto& it: ai_list) {
+        const std::size_t interval = std::max(it.second->interval, (std::size_t)1);
+        if((static_cast<std::size_t>(tick) + it.first) % interval != 0) continue;
+        if(it.second->queued == tick) continue;  //  Already deferred.
+        it.second->queued = tick;
+        it.second->due_since = tick;
+        due.push_back(it);
+      }
+      std::stable_sort(due.begin(), due.end(), [](const ai_entry& a, const ai_entry& b) {
+        if(a.second->due_since != b.second->due_since) return a.second->due_since < b.second->due_since;
+        return a.second->priority > b.second->priority;
+      });
 
       //  Process enabled or disabled ai
-      for(auto& it: ai_components) {
-        (it.second->enabled ?
-          it.second->enabled_ai(it.first) :
-          it.second->disabled_ai(it.first));
+      deferred.clear();
+      const auto start = std::chrono::steady_clock::now();
+      std::size_t ran = 0;
+      for(auto it = due.begin(); it != due.end(); it++) {
+        //  Always run at least one.  The oldest goes first, so deferred AI are never starved.
+        if(budget_us > 0 && ran > 0 && elapsed_us(start) >= budget_us) {
+          deferred.assign(it, due.end());
+          break;
+        }
+        (it->second->enabled ?
+          it->second->enabled_ai(it->first) :
+          it->second->disabled_ai(it->first));
+        ran++;
       }
+
+      _stats.ran = ran;
+      _stats.deferred = deferred.size();
+      if(!deferred.empty()) _stats.overruns++;
+      _stats.time_us = elapsed_us(start);
+
+#if WTE_USE_COROUTINES
+      resume_coroutines();
+#endif
     };
+
+    /*!
+     * \brief Get the scheduling information.
+     * \return Logic scheduling information.
+     */
+    static const schedule_stats& get_stats(void) { return _stats; };
+
+  private:
+    using ai_entry = std::pair<entity_id, cmp::comp_ptr<cmp::ai>>;
+
+    //  Find the entities with ai.  Drop deferred ai that were deleted.
+    void rebuild(void) {
+      const component_container<cmp::ai> ai_components =
+        mgr::world::set_components<cmp::ai>();
+      ai_list.assign(ai_components.begin(), ai_components.end());
+
+      deferred.erase(std::remove_if(deferred.begin(), deferred.end(),
+        [&ai_components](const ai_entry& e) {
+          auto it = ai_components.find(e.first);
+          return (it == ai_components.end() || it->second != e.second);
+        }), deferred.end());
+
+      //  Set before starting coroutines, so changes they make are found next tick.
+      cached_version = mgr::world::get_version();
+      cache_valid = true;
+
+#if WTE_USE_COROUTINES
+      //  Start new coroutines and run them to their first wait.
+      for(auto& it: mgr::world::set_components<cmp::ai_coroutine>()) {
+        if(it.second->started) continue;
+        it.second->started = true;
+        it.second->task.emplace(it.second->routine(it.first));
+        resume(it.first, it.second);
+      }
+#endif
+    };
+
+#if WTE_USE_COROUTINES
+    using co_entry = std::pair<entity_id, std::weak_ptr<cmp::ai_coroutine>>;
+    //  Resume the coroutines whose wait is over.
+    void resume_coroutines(void) {
+      //  Collect first, resuming can add new waits.
+      co_ready.swap(woken);
+      woken.clear();
+      for(auto it = until_waits.begin(); it != until_waits.end();) {
+        auto co = it->second.lock();
+        if(!co || !co->task || co->task->done()) {
+          it = until_waits.erase(it);
+        } else if(co->task->handle.promise().wait_pred()) {
+          co_ready.push_back(*it);
+          it = until_waits.erase(it);
+        } else it++;
+      }
+
+      for(auto& it: co_ready) {
+        auto co = it.second.lock();
+        if(co) resume(it.first, co);
+      }
+      co_ready.clear();
+    };
+
+    //  Resume a coroutine, then wait on what it asked for.
+    void resume(const entity_id& e_id, const cmp::comp_ptr<cmp::ai_coroutine>& co) {
+      if(!co->task || co->task->done()) return;
+      auto& promise = co->task->handle.promise();
+      promise.waiting = cmp::ai_task::wait_type::none;
+      co->task->handle.resume();
+      if(co->task->done()) return;
+
+      std::weak_ptr<cmp::ai_coroutine> weak = co;
+      switch(promise.waiting) {
+        case cmp::ai_task::wait_type::ticks:
+          mgr::timers::schedule_at(promise.wake_tick, e_id,
+            [this, weak](const entity_id& id) { woken.emplace_back(id, weak); });
+          break;
+        case cmp::ai_task::wait_type::message:
+          mgr::messages::listen(mgr::world::get_name(e_id), promise.wait_cmd,
+            [this, e_id, weak](const message& msg) {
+              auto c = weak.lock();
+              if(!c || !c->task || c->task->done()) return;
+              c->task->handle.promise().received = msg;
+              woken.emplace_back(e_id, weak);
+            });
+          break;
+        case cmp::ai_task::wait_type::until:
+          until_waits.emplace_back(e_id, weak);
+          break;
+        default:
+          break;
+      }
+    };
+#endif
+
+    //  Microseconds since a point in time.
+    static int64_t elapsed_us(const std::chrono::steady_clock::time_point& start) {
+      return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    };
+
+    const int64_t budget_us;  //  Time budget each tick in microseconds.
+
+    std::vector<ai_entry> ai_list;   //  Entities with ai.
+    std::vector<ai_entry> due;       //  AI to run this tick.
+    std::vector<ai_entry> deferred;  //  AI left over from last tick.
+    std::size_t cached_version;      //  World version the entities were found for.
+    bool cache_valid;
+
+#if WTE_USE_COROUTINES
+    std::vector<co_entry> until_waits;  //  Waiting on a condition.
+    std::vector<co_entry> woken;        //  Timer or message they were waiting on happened.
+    std::vector<co_entry> co_ready;     //  Resuming this tick.
+#endif
+
+    inline static schedule_stats _stats = { 0, 0, 0, 0 };
 };
 
 }  //  end namespace wte::sys
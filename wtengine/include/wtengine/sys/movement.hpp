@@ -9,6 +9,9 @@
 #define WTE_SYS_MOVEMENT_HPP
 
 #include <cmath>
+#include <vector>
+#include <algorithm>
+#include <limits>
 
 #include "wtengine/sys/system.hpp"
 
@@ -17,10 +20,44 @@ namespace wte::sys {
 /*!
  * \class movement
  * \brief Moves entities based on their velocity.
+ *
+ * The entities to move are cached until components are added or deleted.
+ * Each tick their positions and velocities are copied into packed arrays,
+ * moved and clamped to their bounding boxes in one pass, then copied back.
+ *
+ * Entities with a physics component have their velocity updated first.
+ * This uses semi-implicit Euler, and can be split into sub-steps each tick.
+ *
+ * Entities that have not moved for a number of ticks are put to sleep and skipped.
+ * Sleeping entities are woken when their location, velocity or hitbox size changes,
+ * or a force or acceleration is applied.
  */
 class movement final : public system {
   public:
-    movement() : system("movement") {};
+    /*!
+     * \brief Create the movement system.  Entities sleep after 30 ticks without moving.
+     */
+    movement() : system("movement"), sleep_ticks(30), substeps(1),
+    cached_version(0), cached_sleep_version(0), cache_valid(false) {};
+
+    /*!
+     * \brief Create the movement system, set when entities sleep.
+     * \param s Ticks without moving before an entity sleeps.  Zero to never sleep.
+     */
+    movement(const std::size_t& s) : system("movement"), sleep_ticks(s), substeps(1),
+    cached_version(0), cached_sleep_version(0), cache_valid(false) {};
+
+    /*!
+     * \brief Create the movement system, set when entities sleep and physics sub-steps.
+     * \param s Ticks without moving before an entity sleeps.  Zero to never sleep.
+     * \param p Number of physics sub-steps each tick.
+     */
+    movement(
+      const std::size_t& s,
+      const std::size_t& p
+    ) : system("movement"), sleep_ticks(s), substeps(p > 0 ? p : 1),
+    cached_version(0), cached_sleep_version(0), cache_valid(false) {};
+
     ~movement() = default;
 
     /*!
@@ -29,35 +66,290 @@ class movement final : public system {
      * Also checks entities are within their bounding boxes.
      */
     void run(void) override {
-      //  Find the entities with a motion component.
-      const_component_container<cmp::motion> vel_components
-        = mgr::world::get_components<cmp::motion>();
-      for(auto& it: vel_components) {
-        cmp::const_comp_ptr<cmp::location> temp_get =
-          mgr::world::get_component<cmp::location>(it.first);
-        cmp::comp_ptr<cmp::location> temp_set =
-          mgr::world::set_component<cmp::location>(it.first);
-
-        temp_set->pos_x += (it.second->x_vel * std::cos(it.second->direction));
-        temp_set->pos_y += (it.second->y_vel * std::sin(it.second->direction));
+      if(!cache_valid || cached_version != mgr::world::get_version()) rebuild();
+      wake_changed();
+      if(cached_sleep_version != mgr::world::get_sleep_version()) rebuild_active();
+
+      //  Copy the awake entities into the packed arrays.
+      const std::size_t count = active.size();
+      for(std::size_t i = 0; i < count; i++) {
+        const body& b = bodies[active[i]];
+        pos_x[i] = b.loc->pos_x;
+        pos_y[i] = b.loc->pos_y;
+        if(b.mot) {
+          b.mot->update_direction();
+          vel_x[i] = b.mot->x_vel * b.mot->dir_x;
+          vel_y[i] = b.mot->y_vel * b.mot->dir_y;
+        } else {
+          vel_x[i] = 0.0f;
+          vel_y[i] = 0.0f;
+        }
+        if(b.bbox) {
+          min_x[i] = b.bbox->min_x;
+          min_y[i] = b.bbox->min_y;
+          max_x[i] = b.bbox->max_x;
+          max_y[i] = b.bbox->max_y;
+        }
       }
 
-      //  Now check all bounding boxes.
-      const_component_container<cmp::bounding_box> bbox_components =
+      //  Update the velocity of entities with physics.
+      const std::size_t phys_count = phys_active.size();
+      for(std::size_t k = 0; k < phys_count; k++) {
+        const std::size_t i = phys_active[k];
+        body& b = bodies[active[i]];
+        cmp::physics& p = *b.phys;
+        if(p.drag != b.drag) find_damp(b);
+        phys_vel_x[k] = vel_x[i];
+        phys_vel_y[k] = vel_y[i];
+        const sim_float inv_mass = (p.mass != 0 ? 1 / p.mass : sim_float(0));
+        phys_acc_x[k] = p.accel_x + p.force_x * inv_mass;
+        phys_acc_y[k] = p.accel_y + p.force_y * inv_mass;
+        phys_damp[k] = b.damp;
+        phys_max[k] = p.max_speed;
+        p.force_x = 0;
+        p.force_y = 0;
+      }
+      integrate_physics(phys_count, substeps);
+      for(std::size_t k = 0; k < phys_count; k++) {
+        const std::size_t i = phys_active[k];
+        //  Only write the velocity back if it changed, so the motion keeps the form it was set in.
+        if(phys_vel_x[k] != vel_x[i] || phys_vel_y[k] != vel_y[i])
+          bodies[active[i]].mot->set_velocity(phys_vel_x[k], phys_vel_y[k]);
+        //  Physics entities move by how far they travelled over the sub-steps.
+        vel_x[i] = phys_move_x[k];
+        vel_y[i] = phys_move_y[k];
+      }
+
+      //  Move and clamp.  Kept branch free so the compiler can vectorize it.
+      integrate(count, pos_x.data(), pos_y.data(), vel_x.data(), vel_y.data(),
+                min_x.data(), min_y.data(), max_x.data(), max_y.data());
+
+      //  Copy back to the location components, and sleep entities that stopped.
+      for(std::size_t i = 0; i < count; i++) {
+        body& b = bodies[active[i]];
+        b.loc->pos_x = pos_x[i];
+        b.loc->pos_y = pos_y[i];
+        if(b.hbox) {
+          b.last_w = b.hbox->width;
+          b.last_h = b.hbox->height;
+        }
+
+        if(vel_x[i] == 0.0f && vel_y[i] == 0.0f && pos_x[i] == b.last_x && pos_y[i] == b.last_y)
+          b.still_ticks++;
+        else
+          b.still_ticks = 0;
+        b.last_x = pos_x[i];
+        b.last_y = pos_y[i];
+        if(sleep_ticks > 0 && b.still_ticks >= sleep_ticks) mgr::world::sleep(b.id);
+      }
+    };
+
+  private:
+    //  Components of an entity to move.
+    struct body {
+      entity_id id;
+      cmp::comp_ptr<cmp::location> loc;
+      cmp::comp_ptr<cmp::motion> mot;               //  Null if not moving.
+      cmp::const_comp_ptr<cmp::bounding_box> bbox;  //  Null if not bound.
+      cmp::comp_ptr<cmp::physics> phys;             //  Null if no physics.
+      cmp::const_comp_ptr<cmp::hitbox> hbox;        //  Null if no hitbox.
+      sim_float last_x, last_y;                     //  Location last tick.
+      sim_float last_w, last_h;                     //  Hitbox size last tick.
+      std::size_t still_ticks;                      //  Ticks without moving.
+      sim_float drag;                               //  Physics drag the damping was found for.
+      sim_float damp;                               //  Part of the velocity kept each sub-step.
+    };
+
+    //  Find the entities to move and bound.
+    void rebuild(void) {
+      const component_container<cmp::location> location_components =
+        mgr::world::set_components<cmp::location>();
+      const component_container<cmp::motion> vel_components =
+        mgr::world::set_components<cmp::motion>();
+      const const_component_container<cmp::bounding_box> bbox_components =
         mgr::world::get_components<cmp::bounding_box>();
-      for(auto& it: bbox_components) {
-        cmp::const_comp_ptr<cmp::location> temp_get =
-          mgr::world::get_component<cmp::location>(it.first);
-        cmp::comp_ptr<cmp::location> temp_set =
-          mgr::world::set_component<cmp::location>(it.first);
+      const const_component_container<cmp::hitbox> hitbox_components =
+        mgr::world::get_components<cmp::hitbox>();
+      const component_container<cmp::physics> phys_components =
+        mgr::world::set_components<cmp::physics>();
+
+      //  Keep the still counters of entities that were already cached.
+      std::swap(bodies, old_bodies);
+      bodies.clear();
+      auto old_it = old_bodies.begin();
+      for(auto& it: location_components) {
+        auto mot = vel_components.find(it.first);
+        auto bbox = bbox_components.find(it.first);
+        auto hbox = hitbox_components.find(it.first);
+        //  Entities with only a hitbox are tracked so they can sleep.
+        if(
+          mot == vel_components.end() &&
+          bbox == bbox_components.end() &&
+          hbox == hitbox_components.end()
+        ) continue;
+        //  Physics needs a motion component to update.
+        auto phys = (mot != vel_components.end() ?
+          phys_components.find(it.first) : phys_components.end());
+        bodies.push_back({
+          it.first, it.second,
+          (mot != vel_components.end() ? mot->second : nullptr),
+          (bbox != bbox_components.end() ? bbox->second : nullptr),
+          (phys != phys_components.end() ? phys->second : nullptr),
+          (hbox != hitbox_components.end() ? hbox->second : nullptr),
+          it.second->pos_x, it.second->pos_y,
+          (hbox != hitbox_components.end() ? hbox->second->width : sim_float(0)),
+          (hbox != hitbox_components.end() ? hbox->second->height : sim_float(0)), 0,
+          sim_float(0), sim_float(1)
+        });
+        if(bodies.back().phys) find_damp(bodies.back());
+        //  Both lists are in entity order.
+        while(old_it != old_bodies.end() && old_it->id < it.first) old_it++;
+        if(old_it != old_bodies.end() && old_it->id == it.first) {
+          bodies.back().last_x = old_it->last_x;
+          bodies.back().last_y = old_it->last_y;
+          bodies.back().last_w = old_it->last_w;
+          bodies.back().last_h = old_it->last_h;
+          bodies.back().still_ticks = old_it->still_ticks;
+        }
+      }
+      old_bodies.clear();
 
-        if(temp_get->pos_x < it.second->min_x) temp_set->pos_x = it.second->min_x;
-        else if(temp_get->pos_x > it.second->max_x) temp_set->pos_x = it.second->max_x;
+      cached_version = mgr::world::get_version();
+      cache_valid = true;
+      rebuild_active();
+    };
 
-        if(temp_get->pos_y < it.second->min_y) temp_set->pos_y = it.second->min_y;
-        else if(temp_get->pos_y > it.second->max_y) temp_set->pos_y = it.second->max_y;
+    //  Find the entities that are awake, and size the packed arrays for them.
+    void rebuild_active(void) {
+      active.clear();
+      asleep.clear();
+      phys_active.clear();
+      for(std::size_t i = 0; i < bodies.size(); i++) {
+        if(mgr::world::is_sleeping(bodies[i].id)) {
+          bodies[i].still_ticks = 0;
+          asleep.push_back(i);
+        } else {
+          if(bodies[i].phys) phys_active.push_back(active.size());
+          active.push_back(i);
+        }
       }
+
+      const std::size_t phys_count = phys_active.size();
+      phys_vel_x.resize(phys_count);
+      phys_vel_y.resize(phys_count);
+      phys_acc_x.resize(phys_count);
+      phys_acc_y.resize(phys_count);
+      phys_damp.resize(phys_count);
+      phys_max.resize(phys_count);
+      phys_move_x.resize(phys_count);
+      phys_move_y.resize(phys_count);
+
+      const std::size_t count = active.size();
+      pos_x.resize(count);
+      pos_y.resize(count);
+      vel_x.resize(count);
+      vel_y.resize(count);
+      //  Entities without a bounding box are never clamped.
+      min_x.assign(count, std::numeric_limits<sim_float>::lowest());
+      min_y.assign(count, std::numeric_limits<sim_float>::lowest());
+      max_x.assign(count, std::numeric_limits<sim_float>::max());
+      max_y.assign(count, std::numeric_limits<sim_float>::max());
+
+      cached_sleep_version = mgr::world::get_sleep_version();
     };
+
+    //  Wake sleeping entities whose components were changed since they went to sleep.
+    void wake_changed(void) {
+      for(auto& i: asleep) {
+        body& b = bodies[i];
+        bool changed = (b.loc->pos_x != b.last_x || b.loc->pos_y != b.last_y);
+        if(!changed && b.mot) {
+          b.mot->update_direction();
+          changed = (b.mot->x_vel * b.mot->dir_x != 0 || b.mot->y_vel * b.mot->dir_y != 0);
+        }
+        if(!changed && b.phys)
+          changed = (b.phys->accel_x != 0 || b.phys->accel_y != 0 ||
+                     b.phys->force_x != 0 || b.phys->force_y != 0);
+        if(!changed && b.hbox)
+          changed = (b.hbox->width != b.last_w || b.hbox->height != b.last_h);
+        if(changed) mgr::world::wake(b.id);
+      }
+    };
+
+    //  Split the drag over the sub-steps, so the part lost each tick does not depend on their number.
+    //  Only found when the drag changes, the root is too slow to find each tick.
+    void find_damp(body& b) const {
+      b.drag = b.phys->drag;
+      const sim_float keep = std::max(sim_float(1) - b.drag, sim_float(0));
+      b.damp = sim_math::root(keep, substeps);
+    };
+
+    /*
+     * Semi-implicit Euler over the packed physics arrays.
+     * Each sub-step updates the velocity first, then moves with the new velocity.
+     */
+    void integrate_physics(const std::size_t& count, const std::size_t& steps) {
+      const sim_float dt = sim_float(1) / sim_float(static_cast<int>(steps));
+      for(std::size_t k = 0; k < count; k++) {
+        sim_float vx = phys_vel_x[k], vy = phys_vel_y[k];
+        sim_float mx = 0, my = 0;
+        for(std::size_t s = 0; s < steps; s++) {
+          vx = (vx + phys_acc_x[k] * dt) * phys_damp[k];
+          vy = (vy + phys_acc_y[k] * dt) * phys_damp[k];
+          if(phys_max[k] > 0) {
+            const sim_float speed = sim_math::sqrt(vx * vx + vy * vy);
+            if(speed > phys_max[k]) {
+              vx = vx * phys_max[k] / speed;
+              vy = vy * phys_max[k] / speed;
+            }
+          }
+          mx += vx * dt;
+          my += vy * dt;
+        }
+        phys_vel_x[k] = vx;
+        phys_vel_y[k] = vy;
+        phys_move_x[k] = mx;
+        phys_move_y[k] = my;
+      }
+    };
+
+    //  Add the velocity to the position, then clamp to the bounding box.
+    //  The arrays never overlap, marking them restrict lets the loop vectorize.
+    static void integrate(
+      const std::size_t count,
+      sim_float* __restrict px, sim_float* __restrict py,
+      const sim_float* __restrict vx, const sim_float* __restrict vy,
+      const sim_float* __restrict lx, const sim_float* __restrict ly,
+      const sim_float* __restrict rx, const sim_float* __restrict ry
+    ) {
+      for(std::size_t i = 0; i < count; i++) {
+        px[i] = std::min(std::max(px[i] + vx[i], lx[i]), rx[i]);
+        py[i] = std::min(std::max(py[i] + vy[i], ly[i]), ry[i]);
+      }
+    };
+
+    const std::size_t sleep_ticks;  //  Ticks without moving before sleeping.
+    const std::size_t substeps;     //  Physics sub-steps each tick.
+
+    std::vector<body> bodies;       //  Entities to move and bound.
+    std::vector<body> old_bodies;   //  Used when rebuilding.
+    std::vector<std::size_t> active;  //  Bodies that are awake.
+    std::vector<std::size_t> asleep;  //  Bodies that are sleeping.
+    std::size_t cached_version;     //  World version the entities were found for.
+    std::size_t cached_sleep_version;  //  Sleep version the awake bodies were found for.
+    bool cache_valid;
+
+    //  Packed arrays for the entities.
+    std::vector<sim_float> pos_x, pos_y;
+    std::vector<sim_float> vel_x, vel_y;
+    std::vector<sim_float> min_x, min_y, max_x, max_y;
+
+    //  Packed arrays for the entities with physics.
+    std::vector<std::size_t> phys_active;  //  Index in the packed arrays above.
+    std::vector<sim_float> phys_vel_x, phys_vel_y;
+    std::vector<sim_float> phys_acc_x, phys_acc_y;
+    std::vector<sim_float> phys_damp, phys_max;
+    std::vector<sim_float> phys_move_x, phys_move_y;
 };
 
 }  //  namespace wte::sys